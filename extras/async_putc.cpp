@@ -0,0 +1,56 @@
+/* async_putc.cpp - interrupt driven HAST Transmitter example
+ * 
+ * HAST - Software Defined High-speed Asynchronous Serial Transmitter
+ * 
+ * Copyright (C) 2018 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * https://opensource.org/licenses/MIT
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "hast.hpp"
+
+using tx = hast::avr::transmitter<
+	8000000,					/* 8 MHz					*/
+	hast::_9600,				/* 9600 baud				*/
+	ADDR_OF(PORTB), PORTB3, 0>;	/* pin PORTB3				*/
+
+using async = hast::async<
+	tx,
+	hast::avr::timer0<64>,		/* 8 MHz/64 - 13 ticks per bit	*/
+	32>;						/* ring buffer size			*/
+
+ISR(TIMER0_COMPA_vect) {
+	async::isr();
+}
+
+extern "C"
+void async_init() {
+	async::init();
+	sei();
+}
+
+/** non-blocking, returns 0 if the buffer is full				*/
+extern "C"
+int async_putc(char c) {
+	return async::write(c);
+}
@@ -0,0 +1,119 @@
+/* bench_firmware.cpp - benchmark firmware for HAST Transmitter
+ *
+ * HAST - Software Defined High-speed Asynchronous Serial Transmitter
+ *
+ * Copyright (C) 2018 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * https://opensource.org/licenses/MIT
+ */
+
+/* Built by run_bench.sh for each configuration of the matrix:
+ *   avr-g++ -std=c++11 -Os -mmcu=atmega328p -DF_CPU=8000000 -DBENCH_BAUD=115200
+ *     -DBENCH_STOPBITS=one -DBENCH_DRIVER=driver -I../.. bench_firmware.cpp
+ * Sends the pattern on PB3 byte by byte, as a burst, from flash with send_P
+ * and byte by byte with send_compact. Phases are marked with writes to
+ * GPIOR0, bench_run.cpp timestamps them. A phase the driver or the baud
+ * rate does not support sends nothing and is reported empty			*/
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include "hast.hpp"
+
+#ifndef BENCH_BAUD
+#	define BENCH_BAUD 115200
+#endif
+#ifndef BENCH_STOPBITS
+#	define BENCH_STOPBITS one
+#endif
+#ifndef BENCH_DRIVER
+#	define BENCH_DRIVER driver
+#endif
+
+/* markers, written to GPIOR0												*/
+enum : uint8_t {
+	single_begin  = 1,
+	burst_begin   = 2,
+	flash_begin   = 3,
+	compact_begin = 4,
+	done		  = 5
+};
+
+namespace bench {
+	using driver = hast::avr::driver<ADDR_OF(PORTB), ADDR_OF(DDRB), PORTB3>;
+	using toggle = hast::avr::toggle_driver<ADDR_OF(PINB), ADDR_OF(DDRB),
+		ADDR_OF(PORTB), PORTB3>;
+	using preload = hast::avr::preload_driver<ADDR_OF(PORTB), ADDR_OF(DDRB), PORTB3>;
+}
+
+using tx = hast::transmitter<F_CPU, BENCH_BAUD, bench::BENCH_DRIVER,
+	hast::stopbits::BENCH_STOPBITS>;
+
+static const uint8_t pattern[] = {
+	0xFF, 0x00, 0xF0, 0x0F, 0xCC, 0x33, 0xAA, 0x55,
+	0x01, 0x80, 0x7E, 0x81, 0x3C, 0xC3, 0x5A, 0xA5
+};
+
+/* send_P, not for drivers sending whole frames							*/
+template<bool runs = ! tx::line::whole_frame>
+struct flash_phase {
+	static void run() {
+		tx::send_P(HAST_STR("\xFF\x00\xF0\x0F\xCC\x33\xAA\x55"
+			"\x01\x80\x7E\x81\x3C\xC3\x5A\xA5"));
+	}
+};
+template<>
+struct flash_phase<false> {
+	static void run() {}
+};
+
+/* send_compact, where the compact bit loop fits and is accurate enough	*/
+template<bool runs = ! tx::line::whole_frame && tx::compact::feasible
+	&& tx::compact::error <= tx::milicycles_per_bit / 5>
+struct compact_phase {
+	static void run() {
+		for(uint8_t c : pattern)
+			tx::send_compact(c);
+	}
+};
+template<>
+struct compact_phase<false> {
+	static void run() {}
+};
+
+int main(void) {
+	tx::init();
+	sei();	/* blackout windows are measured against enabled interrupts	*/
+	GPIOR0 = single_begin;
+	for(uint8_t c : pattern)
+		tx::send(c);
+	GPIOR0 = burst_begin;
+	tx::send(pattern, sizeof(pattern));
+	GPIOR0 = flash_begin;
+	flash_phase<>::run();
+	GPIOR0 = compact_begin;
+	compact_phase<>::run();
+	GPIOR0 = done;
+	cli();	/* simavr stops on sleep with interrupts disabled			*/
+	sleep_enable();
+	sleep_cpu();
+	for(;;);
+}
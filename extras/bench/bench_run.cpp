@@ -0,0 +1,194 @@
+/* bench_run.cpp - runs HAST benchmark firmware in simavr
+ *
+ * HAST - Software Defined High-speed Asynchronous Serial Transmitter
+ *
+ * Copyright (C) 2018 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * https://opensource.org/licenses/MIT
+ */
+
+/* Build on the host with simavr installed:
+ *   g++ -std=c++11 bench_run.cpp -lsimavr -lelf -o bench_run
+ * Run:
+ *   ./bench_run firmware.elf atmega328p 8000000 115200
+ * Prints one CSV row:
+ *   single cycles/byte, burst cycles/byte, single bytes/s, burst bytes/s,
+ *   send_P cycles/byte, compact cycles/byte,
+ *   longest interrupt blackout (cycles), worst edge error (ns), errors
+ * send_P and compact cells are empty when the firmware skipped the phase	*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <simavr/sim_avr.h>
+#include <simavr/sim_elf.h>
+#include <simavr/avr_ioport.h>
+using namespace std;
+
+static const uint8_t pattern[] = {	/* same as in bench_firmware.cpp	*/
+	0xFF, 0x00, 0xF0, 0x0F, 0xCC, 0x33, 0xAA, 0x55,
+	0x01, 0x80, 0x7E, 0x81, 0x3C, 0xC3, 0x5A, 0xA5
+};
+static constexpr size_t length = sizeof(pattern);
+static constexpr avr_io_addr_t gpior0 = 0x3E;	/* data space address	*/
+
+/* phase markers, as in bench_firmware.cpp								*/
+enum : uint8_t {
+	single_begin  = 1,
+	burst_begin   = 2,
+	flash_begin   = 3,
+	compact_begin = 4,
+	done		  = 5
+};
+
+struct edge {
+	avr_cycle_count_t at;
+	uint8_t level;
+};
+
+/* state collected while the firmware runs								*/
+struct bench {
+	avr_t* mcu;
+	avr_cycle_count_t marks[done + 1];
+	vector<edge> edges[done];	/* edges of each phase					*/
+	uint8_t phase;
+};
+
+static void on_pin(avr_irq_t*, uint32_t value, void* param) {
+	bench& b = *static_cast<bench*>(param);
+	if( b.phase && b.phase < done )
+		b.edges[b.phase].push_back(edge{b.mcu->cycle, static_cast<uint8_t>(value)});
+}
+
+static void on_marker(avr_t* mcu, avr_io_addr_t addr, uint8_t v, void* param) {
+	bench& b = *static_cast<bench*>(param);
+	mcu->data[addr] = v;
+	if( v <= done ) {
+		b.marks[v] = mcu->cycle;
+		b.phase = v;
+	}
+}
+
+/* level of the trace at the given cycle									*/
+static uint8_t level(const vector<edge>& edges, double at) {
+	uint8_t value = 1;
+	for(const edge& e : edges) {
+		if( e.at > at ) break;
+		value = e.level;
+	}
+	return value;
+}
+
+/* decode 8N1 frames of a phase, count mismatches against the pattern	*/
+static unsigned decode(const vector<edge>& edges, double bit, double ns,
+		double& worst) {
+	unsigned errors = 0;
+	size_t frame = 0, i = 0;
+	while( i < edges.size() && frame < length ) {
+		if( edges[i].level ) { ++i; continue; }
+		const double start = edges[i].at;
+		uint8_t data = 0;
+		for(int k = 0; k < 8; ++k)
+			if( level(edges, start + bit * (k + 1.5)) ) data |= 1 << k;
+		const double stop = start + bit * 9.5;
+		if( ! level(edges, stop) || data != pattern[frame] )
+			++errors;
+		for(++i; i < edges.size() && edges[i].at < stop; ++i) {
+			const double offs = edges[i].at - start;
+			const double ideal = static_cast<long>(offs / bit + 0.5) * bit;
+			const double error = (offs > ideal ? offs - ideal : ideal - offs) * ns;
+			if( error > worst ) worst = error;
+		}
+		++frame;
+	}
+	return errors + length - frame;
+}
+
+int main(int argc, char** argv) {
+	if( argc < 5 ) {
+		fprintf(stderr, "usage: %s firmware.elf mcu frequency baudrate\n", argv[0]);
+		return 2;
+	}
+	const uint32_t frequency = strtoul(argv[3], nullptr, 10);
+	const uint32_t baudrate = strtoul(argv[4], nullptr, 10);
+	elf_firmware_t firmware;
+	memset(&firmware, 0, sizeof(firmware));
+	if( elf_read_firmware(argv[1], &firmware) ) {
+		fprintf(stderr, "%s: can't load\n", argv[1]);
+		return 2;
+	}
+	strncpy(firmware.mmcu, argv[2], sizeof(firmware.mmcu) - 1);
+	firmware.frequency = frequency;
+	avr_t* avr = avr_make_mcu_by_name(firmware.mmcu);
+	if( ! avr ) {
+		fprintf(stderr, "%s: unknown mcu\n", argv[2]);
+		return 2;
+	}
+	avr_init(avr);
+	avr_load_firmware(avr, &firmware);
+
+	bench b;
+	b.mcu = avr;
+	memset(b.marks, 0, sizeof(b.marks));
+	b.phase = 0;
+	avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ('B'), 3),
+		on_pin, &b);
+	avr_register_io_write(avr, gpior0, on_marker, &b);
+
+	/* longest window with interrupts disabled, after sei()			*/
+	avr_cycle_count_t blackout = 0, since = 0;
+	bool masked = false;
+	int state = cpu_Running;
+	while( state != cpu_Done && state != cpu_Crashed && b.phase < done ) {
+		state = avr_run(avr);
+		if( ! b.phase ) continue;
+		if( ! avr->sreg[S_I] && ! masked ) {
+			masked = true;
+			since = avr->cycle;
+		} else if( avr->sreg[S_I] && masked ) {
+			masked = false;
+			if( avr->cycle - since > blackout ) blackout = avr->cycle - since;
+		}
+	}
+	if( b.phase < done ) {
+		fprintf(stderr, "%s: firmware did not finish\n", argv[1]);
+		return 1;
+	}
+	double worst = 0, cycles[done];
+	unsigned errors = 0;
+	for(uint8_t p = single_begin; p < done; ++p) {
+		cycles[p] = double(b.marks[p + 1] - b.marks[p]) / length;
+		if( p >= flash_begin && b.edges[p].empty() ) continue; /* skipped	*/
+		errors += decode(b.edges[p], double(frequency) / baudrate,
+			1e9 / frequency, worst);
+	}
+	printf("%.1f,%.1f,%.0f,%.0f,", cycles[single_begin], cycles[burst_begin],
+		frequency / cycles[single_begin], frequency / cycles[burst_begin]);
+	for(uint8_t p = flash_begin; p < done; ++p)
+		if( b.edges[p].empty() )
+			printf(",");
+		else
+			printf("%.1f,", cycles[p]);
+	printf("%llu,%.0f,%u\n", static_cast<unsigned long long>(blackout),
+		worst, errors);
+	return errors != 0;
+}
@@ -0,0 +1,69 @@
+#!/bin/sh
+# run_bench.sh - HAST benchmark matrix, runs each configuration in simavr
+#
+# HAST - Software Defined High-speed Asynchronous Serial Transmitter
+#
+# Copyright (C) 2018 Eugene Hutorny <eugene@hutorny.in.ua>
+#
+# MIT License, see LICENSE
+#
+# Requires avr-g++, avr-size, simavr (library and headers) and libelf.
+# Usage:
+#   ./run_bench.sh [output-prefix]
+# Writes <prefix>.csv and <prefix>.md (default: bench), commit them to see
+# performance changes of hast.hpp as a diff.
+# Configurations rejected by the compile-time checks are reported as such.
+
+set -e
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+ROOT=$(cd "$HERE/../.." && pwd)
+OUT=${1:-bench}
+BUILD=${BUILD:-$HERE/build}
+MCU=${MCU:-atmega328p}
+CLOCKS=${CLOCKS:-"1000000 8000000 16000000 20000000"}
+BAUDS=${BAUDS:-"9600 57600 115200 230400 460800 921600 2000000"}
+STOPBITS=${STOPBITS:-"one two"}
+DRIVERS=${DRIVERS:-"driver toggle preload"}
+CXX=${CXX:-avr-g++}
+SIZE=${SIZE:-avr-size}
+
+mkdir -p "$BUILD"
+g++ -std=c++11 -O2 "$HERE/bench_run.cpp" -lsimavr -lelf -o "$BUILD/bench_run"
+
+HEADER="clock,baud,stopbits,driver,flash,single cyc/B,burst cyc/B,single B/s,burst B/s,send_P cyc/B,compact cyc/B,blackout cyc,error ns,errors"
+echo "$HEADER" > "$OUT.csv"
+
+for clock in $CLOCKS; do
+for baud in $BAUDS; do
+for sb in $STOPBITS; do
+for drv in $DRIVERS; do
+	name="$BUILD/hast_${clock}_${baud}_${sb}_${drv}"
+	row="$clock,$baud,$sb,$drv"
+	if ! $CXX -std=c++11 -Os -mmcu="$MCU" -DF_CPU="$clock" -DBENCH_BAUD="$baud" \
+		-DBENCH_STOPBITS="$sb" -DBENCH_DRIVER="$drv" -I"$ROOT" \
+		"$HERE/bench_firmware.cpp" -o "$name.elf" 2> "$name.log"; then
+		echo "$row,rejected,,,,,,,,," >> "$OUT.csv"
+		continue
+	fi
+	flash=$($SIZE -A "$name.elf" | awk '$1 == ".text" || $1 == ".data" { s += $2 } END { print s }')
+	if result=$("$BUILD/bench_run" "$name.elf" "$MCU" "$clock" "$baud"); then
+		echo "$row,$flash,$result" >> "$OUT.csv"
+	else
+		echo "$row,$flash,${result:-failed,,,,,,,,}" >> "$OUT.csv"
+	fi
+done
+done
+done
+done
+
+# Markdown table from CSV
+awk -F, 'NR == 1 {
+		printf "|"; for(i = 1; i <= NF; ++i) printf " %s |", $i; printf "\n|";
+		for(i = 1; i <= NF; ++i) printf "%s", (i < 5 ? "---|" : "---:|"); printf "\n";
+		next
+	}
+	{ printf "|"; for(i = 1; i <= NF; ++i) printf " %s |", $i; printf "\n" }' \
+	"$OUT.csv" > "$OUT.md"
+
+echo "Results: $OUT.csv $OUT.md"
@@ -38,4 +38,14 @@ void dbg_putc(char c) {
 			ret load call, start takes more that 7 cycles,
 			needed for the stop bit								*/ 
 	>::send(c);
+}
+
+extern "C"
+void dbg_write(const char* buf, uint8_t len) {
+	hast::avr::transmitter<
+		8000000,					/* 8 MHz					*/
+		hast::_921600,				/* 921600 baud				*/
+		ADDR_OF(PORTB), PORTB3, 0,	/* pin PORTB3				*/
+		hast::stopbits::one			/* burst keeps exact stop bit */
+	>::send(reinterpret_cast<const uint8_t*>(buf), len);
 }
\ No newline at end of file
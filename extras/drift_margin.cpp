@@ -0,0 +1,226 @@
+/* drift_margin.cpp - clock drift tolerance of HAST transmitter time-tables
+ *
+ * HAST - Software Defined High-speed Asynchronous Serial Transmitter
+ *
+ * Copyright (C) 2018 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * https://opensource.org/licenses/MIT
+ */
+
+/* Build and run on the host:
+ *   g++ -std=c++11 -I.. drift_margin.cpp -o drift_margin
+ *   ./drift_margin [sigma%] [trials]
+ * Feeds the edges of each configuration's time-table (t<bit>::rfinish) to
+ * a model of a 16x oversampling receiver with majority of samples 7, 8, 9,
+ * as in AVR USART. The same model runs on the ideal edges too, so the
+ * cost of the time-table's own edge error shows apart from the drift.
+ * For each clock and baudrate it prints:
+ *   err%		- worst data edge error of the time-table (t<bit>::error)
+ *   safe		- clock deviation window, in which frames decode at any
+ *				  receiver sampling phase
+ *   loss		- how much narrower the window is than with ideal edges
+ *   P(error)	- frame error probability, Monte Carlo, with the clock
+ *				  deviation normally distributed with sigma (default 1%)
+ *				  and a uniform sampling phase
+ *   ideal		- the same for ideal edges, with the same random draws
+ * Deviation is the relative one of both ends, transmitter to receiver.
+ * The fastest baudrate with the safe window beyond +-3 sigma is marked
+ * with '*'. Configurations the transmitter rejects are not built, they
+ * are listed as rejected. Adjacent bits are assumed to differ (0x55),
+ * the worst case														*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include "hast.hpp"
+using namespace std;
+
+using line = hast::avr::driver<34,33,32,0>;
+
+/* edges of the frame in cycles: end of the start bit, data bits, stop	*/
+struct frame_edges {
+	static constexpr uint8_t slots = 10;
+	double at[slots];
+	double clock;
+	double baud;
+	double error;	/* worst data edge error, fraction of bit			*/
+	bool valid;		/* accepted by the transmitter						*/
+};
+
+template<typename tx, uint8_t ... bit>
+static frame_edges collect(hast::clock_t clock, hast::clock_t baud,
+		hast::indices<bit...>) {
+	const double at[] = { double(tx::template t<bit>::rfinish)... };
+	const double errors[] = { double(tx::template t<bit>::error)... };
+	frame_edges res;
+	res.clock = clock;
+	res.baud = baud;
+	res.error = 0;
+	res.valid = true;
+	for(uint8_t i = 0; i < frame_edges::slots; ++i) {
+		res.at[i] = at[i];
+		if( i + 1 < frame_edges::slots && errors[i] / tx::milicycles_per_bit > res.error )
+			res.error = errors[i] / tx::milicycles_per_bit;
+	}
+	return res;
+}
+
+/* the same frame with its edges at the ideal times					*/
+static frame_edges ideal(const frame_edges& f) {
+	frame_edges res = f;
+	for(uint8_t i = 0; i < frame_edges::slots; ++i)
+		res.at[i] = (i + 1) * f.clock / f.baud;
+	res.error = 0;
+	return res;
+}
+
+/* true if the sample at t (in bits of the receiver) falls into slot k	*/
+static bool inside(const frame_edges& f, double scale, uint8_t k, double t) {
+	const double from = k == 0 ? 0 : f.at[k - 1] * scale;
+	const double to = k + 1 == frame_edges::slots ? 1e9 : f.at[k] * scale;
+	return t >= from && t < to;
+}
+
+/* frame decodes with the deviation and the sampling phase (0..1)		*/
+static bool decodes(const frame_edges& f, double deviation, double phase) {
+	/* cycles of the transmitter in bits of the receiver					*/
+	const double scale = f.baud / (f.clock * (1 + deviation));
+	const double tick = 1.0 / 16;
+	const double detected = phase * tick;
+	for(uint8_t k = 0; k < frame_edges::slots; ++k) {
+		uint8_t votes = 0;
+		for(uint8_t s = 7; s <= 9; ++s)
+			votes += inside(f, scale, k, detected + (16 * k + s) * tick);
+		if( votes < 2 ) return false;
+	}
+	return true;
+}
+
+static constexpr unsigned phases = 64;
+static constexpr double step = 0.0001;
+
+static bool holds(const frame_edges& f, double deviation) {
+	for(unsigned p = 0; p < phases; ++p)
+		if( ! decodes(f, deviation, (p + 0.5) / phases) ) return false;
+	return true;
+}
+
+/* largest deviation in the direction (+1/-1) that still holds			*/
+static double margin(const frame_edges& f, int direction) {
+	double d = 0;
+	while( d < 0.1 && holds(f, direction * (d + step)) ) d += step;
+	return holds(f, 0) ? d : -1;
+}
+
+static double probability(const frame_edges& f, double sigma, unsigned trials) {
+	mt19937 rng(2018);
+	normal_distribution<double> deviation(0, sigma);
+	uniform_real_distribution<double> phase(0, 1);
+	unsigned failed = 0;
+	for(unsigned i = 0; i < trials; ++i)
+		failed += ! decodes(f, deviation(rng), phase(rng));
+	return double(failed) / trials;
+}
+
+static double sigma = 0.01;
+static unsigned trials = 100000;
+
+/* rates the transmitter rejects are not instantiated, the solver
+ * probes them without failing the build								*/
+template<hast::clock_t clock, hast::clock_t baud,
+	bool valid = hast::best<clock, line>::template valid<baud>()>
+struct edges {
+	static frame_edges get() {
+		using tx = hast::transmitter<clock, baud, line>;
+		return collect<tx>(clock, baud, hast::make_indices<frame_edges::slots>::type());
+	}
+};
+template<hast::clock_t clock, hast::clock_t baud>
+struct edges<clock, baud, false> {
+	static frame_edges get() {
+		frame_edges res = frame_edges();
+		res.clock = clock;
+		res.baud = baud;
+		return res;
+	}
+};
+
+template<hast::clock_t clock>
+static void print_clock() {
+	const frame_edges list[] = {
+		edges<clock, hast::_9600>::get(),
+		edges<clock, hast::_19200>::get(),
+		edges<clock, hast::_38400>::get(),
+		edges<clock, hast::_57600>::get(),
+		edges<clock, hast::_115200>::get(),
+		edges<clock, hast::_230400>::get(),
+		edges<clock, hast::_460800>::get(),
+		edges<clock, hast::_921600>::get()
+	};
+	const size_t count = sizeof(list) / sizeof(list[0]);
+	double below[count], above[count], loss[count], failing[count], exact[count];
+	size_t fastest = count;
+	for(size_t i = 0; i < count; ++i) {
+		if( ! list[i].valid ) continue;
+		const frame_edges best = ideal(list[i]);
+		below[i] = margin(list[i], -1);
+		above[i] = margin(list[i], +1);
+		loss[i] = margin(best, -1) + margin(best, +1) - below[i] - above[i];
+		failing[i] = probability(list[i], sigma, trials);
+		exact[i] = probability(best, sigma, trials);
+		if( below[i] >= 3 * sigma && above[i] >= 3 * sigma ) fastest = i;
+	}
+	for(size_t i = 0; i < count; ++i) {
+		if( ! list[i].valid )
+			printf(": %8llu : %6llu :      - :  rejected by hast  :      - :        - :        - : :\n",
+				static_cast<unsigned long long>(clock),
+				static_cast<unsigned long long>(list[i].baud));
+		else if( below[i] < 0 )
+			printf(": %8llu : %6llu : %5.1f%% :  does not decode   :      - :        - : %8.2e : :\n",
+				static_cast<unsigned long long>(clock),
+				static_cast<unsigned long long>(list[i].baud),
+				100 * list[i].error, exact[i]);
+		else
+			printf(": %8llu : %6llu : %5.1f%% : -%5.2f%% .. +%5.2f%% : %5.2f%% : %8.2e : %8.2e :%c:\n",
+				static_cast<unsigned long long>(clock),
+				static_cast<unsigned long long>(list[i].baud),
+				100 * list[i].error, 100 * below[i], 100 * above[i], 100 * loss[i],
+				failing[i], exact[i], i == fastest ? '*' : ' ');
+	}
+}
+
+int main(int argc, char** argv) {
+	if( argc > 1 ) sigma = atof(argv[1]) / 100;
+	if( argc > 2 ) trials = strtoul(argv[2], nullptr, 10);
+	if( sigma <= 0 || trials == 0 ) {
+		fprintf(stderr, "usage: %s [sigma%%] [trials]\n", argv[0]);
+		return 2;
+	}
+	printf("clock deviation sigma %.2f%%, %u trials per configuration\n",
+		100 * sigma, trials);
+	printf(":   clock  :  baud  :  err%%  :    safe window     :  loss  : P(error) :  ideal   : :\n");
+	printf(":----------:--------:--------:--------------------:--------:----------:----------:-:\n");
+	print_clock<1000000>();
+	print_clock<8000000>();
+	print_clock<16000000>();
+	print_clock<20000000>();
+	return 0;
+}
@@ -0,0 +1,222 @@
+/* hast_log.cpp - host-side decoder for HAST deferred binary log
+ *
+ * HAST - Software Defined High-speed Asynchronous Serial Transmitter
+ *
+ * Copyright (C) 2018 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * https://opensource.org/licenses/MIT
+ */
+
+/* Build and run on the host:
+ *   g++ -std=c++11 hast_log.cpp -o hast_log
+ *   stty -F /dev/ttyUSB0 921600 raw && ./hast_log firmware.elf < /dev/ttyUSB0
+ * Reads format strings from .hast_log section of the firmware ELF file,
+ * decodes COBS packets from stdin (or capture file) and prints the records.
+ * Argument sizes follow the target ABI: int is 2 bytes on AVR.
+ * Host programs using HAST_LOG must be linked with -no-pie
+ * sim_check.cpp includes this file with HAST_LOG_NO_MAIN to test it	*/
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+using namespace std;
+
+/* target type sizes, derived from the ELF header							*/
+struct abi {
+	unsigned int_size;
+	unsigned long_size;
+	unsigned double_size;
+	unsigned pointer_size;
+};
+
+static uint64_t le(const uint8_t* p, unsigned size) {
+	uint64_t v = 0;
+	for(unsigned i = size; i > 0; --i)
+		v = (v << 8) | p[i-1];
+	return v;
+}
+
+/* load .hast_log section from a little endian ELF32/ELF64 file			*/
+static bool load(const char* name, vector<char>& strings, abi& target) {
+	FILE* f = fopen(name, "rb");
+	if( ! f ) return false;
+	vector<uint8_t> elf;
+	uint8_t buf[4096];
+	size_t n;
+	while( (n = fread(buf, 1, sizeof(buf), f)) > 0 )
+		elf.insert(elf.end(), buf, buf + n);
+	fclose(f);
+	if( elf.size() < 64 || memcmp(elf.data(), "\177ELF", 4) || elf[5] != 1 )
+		return false;
+	const bool wide = elf[4] == 2;
+	const unsigned machine = le(&elf[18], 2);
+	const uint64_t shoff = wide ? le(&elf[40], 8) : le(&elf[32], 4);
+	const unsigned shentsize = le(&elf[wide ? 58 : 46], 2);
+	const unsigned shnum = le(&elf[wide ? 60 : 48], 2);
+	const unsigned shstrndx = le(&elf[wide ? 62 : 50], 2);
+	if( shoff + shentsize * shnum > elf.size() || shstrndx >= shnum )
+		return false;
+	auto field = [&](unsigned i, unsigned off32, unsigned off64) {
+		const uint8_t* sh = &elf[shoff + shentsize * i];
+		return wide ? le(sh + off64, 8) : le(sh + off32, 4);
+	};
+	const uint64_t names = field(shstrndx, 16, 24);
+	for(unsigned i = 0; i < shnum; ++i) {
+		const uint64_t name_at = names + le(&elf[shoff + shentsize * i], 4);
+		if( name_at >= elf.size() ) continue;
+		if( strcmp(reinterpret_cast<const char*>(&elf[name_at]), ".hast_log") )
+			continue;
+		const uint64_t offset = field(i, 16, 24);
+		const uint64_t size = field(i, 20, 32);
+		if( offset + size > elf.size() ) return false;
+		strings.assign(elf.begin() + offset, elf.begin() + offset + size);
+		strings.push_back(0);
+		const bool avr = machine == 83;	/* EM_AVR						*/
+		target.int_size = avr ? 2 : 4;
+		target.long_size = wide ? 8 : 4;
+		target.double_size = avr ? 4 : 8;
+		target.pointer_size = avr ? 2 : (wide ? 8 : 4);
+		return true;
+	}
+	return false;
+}
+
+static uint16_t crc16(const uint8_t* data, size_t n) {
+	uint16_t crc = 0xFFFF;
+	while( n-- ) {
+		crc ^= *data++ << 8;
+		for(int i = 0; i < 8; ++i)
+			crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+	}
+	return crc;
+}
+
+/* decode COBS packet in place, returns false if malformed				*/
+static bool unstuff(vector<uint8_t>& packet) {
+	vector<uint8_t> out;
+	size_t i = 0;
+	while( i < packet.size() ) {
+		const uint8_t code = packet[i++];
+		if( code == 0 || i + code - 1 > packet.size() ) return false;
+		out.insert(out.end(), packet.begin() + i, packet.begin() + i + code - 1);
+		i += code - 1;
+		if( code != 0xFF && i < packet.size() ) out.push_back(0);
+	}
+	packet.swap(out);
+	return true;
+}
+
+/* render format with arguments, sizes are as on the target				*/
+static string render(const char* fmt, const uint8_t* args, size_t n, const abi& target) {
+	string out;
+	char text[64];
+	while( *fmt ) {
+		if( *fmt != '%' ) { out += *fmt++; continue; }
+		const char* spec = fmt++;
+		if( *fmt == '%' ) { out += '%'; ++fmt; continue; }
+		while( strchr("-+ #0123456789.", *fmt) && *fmt ) ++fmt;
+		const char* flags_end = fmt;
+		unsigned size = target.int_size;
+		if( fmt[0] == 'h' && fmt[1] == 'h' ) { size = 1; fmt += 2; }
+		else if( fmt[0] == 'h' ) { size = 2; ++fmt; }
+		else if( fmt[0] == 'l' && fmt[1] == 'l' ) { size = 8; fmt += 2; }
+		else if( fmt[0] == 'l' ) { size = target.long_size; ++fmt; }
+		const char conv = *fmt ? *fmt++ : 0;
+		if( strchr("fFeEgGaA", conv) ) size = target.double_size;
+		if( conv == 'c' ) size = 1;
+		if( conv == 'p' ) size = target.pointer_size;
+		if( conv == 's' || conv == 0 || size > n ) {
+			out += "<?>";
+			break;
+		}
+		const string head(spec, flags_end - spec);
+		const uint64_t raw = le(args, size);
+		args += size;
+		n -= size;
+		if( strchr("fFeEgGaA", conv) ) {
+			double v;
+			if( size == 4 ) { float f; memcpy(&f, &raw, 4); v = f; }
+			else memcpy(&v, &raw, 8);
+			snprintf(text, sizeof(text), (head + conv).c_str(), v);
+		} else if( conv == 'd' || conv == 'i' ) {
+			const int64_t v = static_cast<int64_t>(raw << (64 - 8 * size)) >> (64 - 8 * size);
+			snprintf(text, sizeof(text), (head + "ll" + conv).c_str(), static_cast<long long>(v));
+		} else if( conv == 'c' ) {
+			snprintf(text, sizeof(text), (head + conv).c_str(), static_cast<int>(raw));
+		} else if( conv == 'p' ) {
+			snprintf(text, sizeof(text), "0x%llx", static_cast<unsigned long long>(raw));
+		} else {
+			snprintf(text, sizeof(text), (head + "ll" + conv).c_str(),
+				static_cast<unsigned long long>(raw));
+		}
+		out += text;
+	}
+	return out;
+}
+
+#ifndef HAST_LOG_NO_MAIN
+int main(int argc, char** argv) {
+	if( argc < 2 ) {
+		fprintf(stderr, "usage: %s firmware.elf [capture.bin]\n", argv[0]);
+		return 2;
+	}
+	vector<char> strings;
+	abi target;
+	if( ! load(argv[1], strings, target) ) {
+		fprintf(stderr, "%s: no .hast_log section\n", argv[1]);
+		return 2;
+	}
+	FILE* in = argc > 2 ? fopen(argv[2], "rb") : stdin;
+	if( ! in ) {
+		perror(argv[2]);
+		return 2;
+	}
+	vector<uint8_t> packet;
+	unsigned errors = 0;
+	int c;
+	while( (c = fgetc(in)) != EOF ) {
+		if( c ) {
+			packet.push_back(c);
+			continue;
+		}
+		if( packet.empty() ) continue;
+		if( ! unstuff(packet) || packet.size() < 4 ||
+			crc16(packet.data(), packet.size() - 2) !=
+				((packet[packet.size()-2] << 8) | packet.back()) ) {
+			printf("<corrupted record>\n");
+			++errors;
+		} else {
+			const uint16_t id = le(packet.data(), 2);
+			if( id >= strings.size() ) {
+				printf("<unknown id %u>\n", id);
+				++errors;
+			} else
+				printf("%s\n", render(&strings[id], &packet[2],
+					packet.size() - 4, target).c_str());
+		}
+		fflush(stdout);
+		packet.clear();
+	}
+	return errors != 0;
+}
+#endif
@@ -58,12 +58,38 @@ using test460k = hast::transmitter<clock,hast::_460800,
 using test920k = hast::transmitter<clock,hast::_921600,
 		hast::avr::driver<34,33,32,0>>;
 
+using test920k_minimax = hast::transmitter<clock,hast::_921600,
+		hast::avr::driver<34,33,32,0>, hast::stopbits::one,
+		hast::timetable::minimax>;
+
+using test3m_toggle = hast::transmitter<clock,3000000,
+		hast::avr::toggle_driver<32,33,34,0,0>>;
+
+using recv115k = hast::receiver<clock,hast::_115200,
+		hast::avr::input<35,34,33,0,0>>;
+
+using recv1m = hast::receiver<clock,1000000,
+		hast::avr::input<35,34,33,0,0>>;
+
 namespace hast {
-	template<clock_t clock, clock_t baudrate, typename driver, stopbits stopbit>
+	template<clock_t clock, clock_t baudrate, typename driver, stopbits stopbit,
+		timetable engine, typename format>
 	template<uint8_t bit>
-	void transmitter<clock, baudrate, driver, stopbit>::t<bit>::debug() {
-		printf(":%d :%8lld :%8lld :%6u :%6u : %4d :%5lld :%5.1f%% :\n",
+	void transmitter<clock, baudrate, driver, stopbit, engine, format>::t<bit>::debug() {
+		printf(":%d :%8lld :%8lld :%6u :%6u : %4d :%5lld :%5.1f%% :%5.1f%% :\n",
 			bit, mstart, mfinish, rstart, rfinish, wait, error,
+			(100.0 * error) / milicycles_per_bit,
+			(100.0 * serror) / milicycles_per_bit
+		);
+	}
+}
+
+namespace hast {
+	template<clock_t clock, clock_t baudrate, typename driver>
+	template<uint8_t bit>
+	void receiver<clock, baudrate, driver>::r<bit>::debug() {
+		printf(":%d :%8lld :%8lld :%6u :%6u : %4d :%5lld :%5.1f%% :\n",
+			bit, mpoint, mili * rpoint, rstart, rpoint, wait, error,
 			(100.0 * error) / milicycles_per_bit
 		);
 	}
@@ -86,6 +112,41 @@ struct iterate<T, V, L...> {
 	}
 };
 
+template<hast::clock_t clock>
+void print_best() {
+	using solver = hast::best<clock, hast::avr::driver<34,33,32,0>>;
+	static constexpr hast::clock_t baud = solver::fastest();
+	printf(": %8llu : %6llu : %5.1f%% : %6d : %d :\n",
+		static_cast<unsigned long long>(clock),
+		static_cast<unsigned long long>(baud),
+		solver::template error<baud>() / 10.0,
+		solver::template frame_cycles<baud>(),
+		static_cast<int>(solver::template stopbit_for<baud>()));
+}
+
+/* worst data edge error of the unrolled time-table					*/
+template<typename tx, uint8_t bit = 0, bool last = (bit + 1 == tx::stop_slot)>
+struct worst {
+	static constexpr hast::milicycle_t error =
+		tx::template t<bit>::error > worst<tx, bit + 1>::error
+		? tx::template t<bit>::error : worst<tx, bit + 1>::error;
+};
+template<typename tx, uint8_t bit>
+struct worst<tx, bit, true> {
+	static constexpr hast::milicycle_t error = tx::template t<bit>::error;
+};
+
+/* ROM of the bit sequences and paddings vs error, unrolled and compact	*/
+template<hast::clock_t clock, hast::clock_t baud>
+void print_compact() {
+	using tx = hast::transmitter<clock, baud, hast::avr::driver<34,33,32,0>>;
+	printf(": %8llu : %6llu : %5d : %5.1f%% : %5d : %5.1f%% :\n",
+		static_cast<unsigned long long>(clock),
+		static_cast<unsigned long long>(baud),
+		tx::words(), 100.0 * worst<tx>::error / tx::milicycles_per_bit,
+		tx::compact::words, 100.0 * tx::compact::error / tx::milicycles_per_bit);
+}
+
 void print_section(hast::clock_t baud, hast::clock_t clock) {
 	printf(":--:---------:---------:-------:-------:------:------:-------:\n");
 	printf(": Baudrate %6lld, clock %8lld Hz                         :\n",
@@ -95,7 +156,7 @@ void print_section(hast::clock_t baud, hast::clock_t clock) {
 
 
 int main() {
-	printf(":# : mstart  : mfinish : rstart:rfinish: wait : error:  err%% :\n");
+	printf(":# : mstart  : mfinish : rstart:rfinish: wait : error:  err%% : serr%% :\n");
 	print_section(115200, clock);
 	iterate<test115k::t,0,1,2,3,4,5,6,7,8,9>::debug();
 	print_section(230400, clock);
@@ -104,5 +165,29 @@ int main() {
 	iterate<test460k::t,0,1,2,3,4,5,6,7,8,9>::debug();
 	print_section(921600, clock);
 	iterate<test920k::t,0,1,2,3,4,5,6,7,8,9>::debug();
+	print_section(921600, clock);
+	iterate<test920k_minimax::t,0,1,2,3,4,5,6,7,8,9>::debug();
+	print_section(3000000, clock);
+	iterate<test3m_toggle::t,0,1,2,3,4,5,6,7,8,9>::debug();
+	printf("\n:# : mpoint  : rpoint  : rstart:rpoint : wait : error:  err%% :\n");
+	print_section(115200, clock);
+	iterate<recv115k::r,0,1,2,3,4,5,6,7,8>::debug();
+	print_section(1000000, clock);
+	iterate<recv1m::r,0,1,2,3,4,5,6,7,8>::debug();
+	printf("\n:   clock  :  baud  :  err%%  : frame  :sb:\n");
+	print_best<1000000>();
+	print_best<4000000>();
+	print_best<8000000>();
+	print_best<16000000>();
+	print_best<20000000>();
+	printf("\n:          :        :    unrolled    :    compact     :\n");
+	printf(":   clock  :  baud  : words :  err%%  : words :  err%%  :\n");
+	print_compact<1000000, hast::_9600>();
+	print_compact<1000000, hast::_57600>();
+	print_compact<8000000, hast::_9600>();
+	print_compact<8000000, hast::_115200>();
+	print_compact<8000000, hast::_460800>();
+	print_compact<16000000, hast::_115200>();
+	print_compact<16000000, hast::_921600>();
 	return 0;
 }
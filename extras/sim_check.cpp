@@ -0,0 +1,1078 @@
+/* sim_check.cpp - host-side timing regression check for HAST Transmitter
+ *
+ * HAST - Software Defined High-speed Asynchronous Serial Transmitter
+ *
+ * Copyright (C) 2018 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * https://opensource.org/licenses/MIT
+ */
+
+/* Build and run on the host:
+ *   g++ -std=c++11 -I.. sim_check.cpp -o sim_check && ./sim_check [file.vcd]
+ * Build with -std=c++14 to check the flat time-table engine as well,
+ * with -no-pie to check HAST_LOG IDs against hast_log, not only the text
+ * Built without HAST_DEBUG, so every listed setup must also pass the
+ * library's compile-time checks. A row fails if any frame fails to decode
+ * or an edge is off by more than 20% of a bit; the exit status is non-zero
+ * if any row fails.
+ * NOTE: sim drivers take *_cycles constants from the AVR drivers they
+ * model, a wrong count in an AVR driver is copied, not caught. Cycle
+ * counts are verified only against the generated code or in simavr		*/
+
+#include <cstdio>
+#include <vector>
+#include "hast_sim.hpp"
+#define HAST_LOG_NO_MAIN
+#include "hast_log.cpp"
+using namespace std;
+
+using line = hast::sim::driver<34,33,32,0>;
+using toggle = hast::sim::toggle_driver<32,33,34,0,0>;
+using preload = hast::sim::preload_driver<34,33,32,0>;
+
+static const uint8_t pattern[] = {
+	0xFF, 0x00, 0xF0, 0x0F, 0xCC, 0x33, 0xAA, 0x55, 0x01, 0x80
+};
+static constexpr size_t length = sizeof(pattern);
+static FILE* vcd = nullptr;
+
+/* worst edge error within 20% of a bit, the limit of the library's
+ * compile-time check													*/
+template<typename uart>
+static bool accurate(const typename uart::report& res) {
+	return res.max_error <= uart::bit_ns / 5;
+}
+
+/* start edges of 8N1 frames in the trace, an edge to SPACE after the
+ * previous frame's stop bit sampling point starts a frame				*/
+static vector<hast::cycle_t> starts(const hast::sim::trace_t& edges, double bit) {
+	vector<hast::cycle_t> res;
+	double next = 0;
+	for(const hast::sim::edge& e : edges)
+		if( e.level == 0 && e.at >= next ) {
+			res.push_back(e.at);
+			next = e.at + bit * 9.5;
+		}
+	return res;
+}
+
+/* frames of a burst must follow each other by the time-table's frame
+ * length, the stop bit taking the loop branch and the next byte's
+ * preparation, longer by -gap if gap is negative. A model that loses the
+ * branch makes stop bits short											*/
+template<typename tx>
+static bool paced(const hast::sim::trace_t& edges, size_t n, hast::cycle_t gap) {
+	const hast::cycle_t period = tx::template t<tx::stop_slot>::rfinish
+		- (gap < 0 ? gap : 0);
+	const vector<hast::cycle_t> at = starts(edges,
+		static_cast<double>(tx::milicycles_per_bit) / hast::mili);
+	for(size_t i = 1; i < at.size(); ++i)
+		if( at[i] - at[i - 1] != period ) return false;
+	return at.size() == n;
+}
+
+/* work in the padding, each slice advances the simulated clock by its
+ * cost and counts itself, so the frame must keep its timing			*/
+struct work {
+	static constexpr uint8_t slices = 6;
+	static constexpr hast::cycle_t cost(uint8_t i) { return 2 + (i & 1) * 3; }
+	static unsigned done;
+	template<uint8_t i>
+	static inline void slice() {
+		hast::sim::advance(cost(i));
+		done += done == i;
+	}
+};
+unsigned work::done = 0;
+
+/* sends the pattern with work, expects the same timing as without	*/
+template<typename tx, typename uart, bool fits = ! tx::line::whole_frame
+	&& tx::template fits<work>()>
+struct check_work {
+	static bool run(hast::cycle_t expected) {
+		tx::init();
+		for(uint8_t c : pattern) {
+			work::done = 0;
+			tx::template send<work>(c);
+			if( work::done != work::slices ) return false;
+		}
+		return uart::decode(hast::sim::trace(), pattern, length).errors == 0
+			&& hast::sim::now() == expected;
+	}
+};
+template<typename tx, typename uart>
+struct check_work<tx, uart, false> { /* no room for work at this rate	*/
+	static bool run(hast::cycle_t) { return true; }
+};
+
+template<hast::clock_t clock, hast::clock_t baud, hast::stopbits sb,
+	typename drv = line>
+static bool check() {
+	using tx = hast::transmitter<clock, baud, drv, sb>;
+	using uart = hast::sim::uart<clock, baud>;
+	if( tx::milicycles_per_bit < hast::mili * drv::send_cycles )
+		return true; /* out of the driver's range, rejected by static_warn	*/
+	tx::init();
+	for(uint8_t c : pattern) tx::send(c);
+	auto single = uart::decode(hast::sim::trace(), pattern, length);
+	const hast::cycle_t single_cycles = hast::sim::now();
+	tx::init();
+	tx::send(pattern, length);
+	auto burst = uart::decode(hast::sim::trace(), pattern, length);
+	const bool periodic = paced<tx>(hast::sim::trace(), length, tx::burst::gap);
+	const hast::cycle_t burst_cycles = hast::sim::now();
+	if( vcd ) { /* burst of the first configuration only				*/
+		hast::sim::vcd<clock>(vcd, hast::sim::trace());
+		fclose(vcd);
+		vcd = nullptr;
+	}
+	const bool ok = single.errors == 0 && burst.errors == 0 &&
+		accurate<uart>(single) && accurate<uart>(burst) && periodic &&
+		check_work<tx, uart>::run(single_cycles);
+	printf(": %8lu : %6lu : %u : %6lld : %6lld : %5u : %5u : %s :\n",
+		static_cast<unsigned long>(clock), static_cast<unsigned long>(baud),
+		static_cast<unsigned>(sb),
+		static_cast<long long>(single.max_error),
+		static_cast<long long>(burst.max_error),
+		static_cast<unsigned>(single_cycles / length),
+		static_cast<unsigned>(burst_cycles / length),
+		ok ? "ok  " : "FAIL");
+	return ok;
+}
+
+/* compact mode must decode and keep the error it reports				*/
+template<hast::clock_t clock, hast::clock_t baud, typename format = hast::frame<>,
+	typename drv = line>
+static bool check_compact() {
+	using tx = hast::transmitter<clock, baud, drv, hast::stopbits::one,
+		hast::timetable::greedy, format>;
+	using uart = hast::sim::uart<clock, baud, 0, format>;
+	typename format::data_t data[length];
+	for(size_t i = 0; i < length; ++i)
+		data[i] = (pattern[i] | (i & 1 ? 0x100 : 0)) & ((1U << format::data_bits) - 1);
+	tx::init();
+	for(auto c : data) tx::send_compact(c);
+	auto res = uart::decode(hast::sim::trace(), data, length);
+	const hast::time_t reported = (hast::nano * tx::compact::error)
+		/ (hast::mili * clock);
+	const hast::time_t rounding = hast::nano / static_cast<hast::time_t>(clock) / 16 + 1;
+	const bool ok = res.errors == 0 && res.max_error <= reported + rounding;
+	printf(": %8lu : %6lu : %u : %6lld : %6lld : %5u : %5u : %s :\n",
+		static_cast<unsigned long>(clock), static_cast<unsigned long>(baud),
+		static_cast<unsigned>(format::bits), static_cast<long long>(res.max_error),
+		static_cast<long long>(reported),
+		static_cast<unsigned>(tx::words()), static_cast<unsigned>(tx::compact::words),
+		ok ? "ok  " : "FAIL");
+	return ok;
+}
+
+template<hast::clock_t clock, hast::clock_t baud, typename format,
+	typename drv = line>
+static bool check_format(const char* name) {
+	using tx = hast::transmitter<clock, baud, drv, hast::stopbits::one,
+		hast::timetable::greedy, format>;
+	using uart = hast::sim::uart<clock, baud, 0, format>;
+	typename format::data_t data[length];
+	for(size_t i = 0; i < length; ++i)
+		data[i] = (pattern[i] | (i & 1 ? 0x100 : 0)) & ((1U << format::data_bits) - 1);
+	tx::init();
+	for(auto c : data) tx::send(c);
+	auto res = uart::decode(hast::sim::trace(), data, length);
+	const bool ok = res.errors == 0 && accurate<uart>(res);
+	printf(": %8lu : %6lu : %-5s : %6lld : %5u : %s :\n",
+		static_cast<unsigned long>(clock), static_cast<unsigned long>(baud),
+		name, static_cast<long long>(res.max_error),
+		static_cast<unsigned>(hast::sim::now() / length),
+		ok ? "ok  " : "FAIL");
+	return ok;
+}
+
+/* every value of the data bits, parity of each must decode			*/
+template<hast::clock_t clock, hast::clock_t baud, typename format,
+	typename drv = line>
+static bool check_values(const char* name) {
+	using tx = hast::transmitter<clock, baud, drv, hast::stopbits::one,
+		hast::timetable::greedy, format>;
+	using uart = hast::sim::uart<clock, baud, 0, format>;
+	static constexpr size_t count = 1U << format::data_bits;
+	typename format::data_t data[count];
+	for(size_t i = 0; i < count; ++i)
+		data[i] = static_cast<typename format::data_t>(i);
+	tx::init();
+	for(auto c : data) tx::send(c);
+	auto res = uart::decode(hast::sim::trace(), data, count);
+	const bool ok = res.errors == 0 && accurate<uart>(res);
+	printf(": %8lu : %6lu : %-5s : %6lld : %5u : %s :\n",
+		static_cast<unsigned long>(clock), static_cast<unsigned long>(baud),
+		name, static_cast<long long>(res.max_error),
+		static_cast<unsigned>(hast::sim::now() / count),
+		ok ? "ok  " : "FAIL");
+	return ok;
+}
+
+#if __cplusplus >= 201402L
+/* rows of the flat array against the t<bit> chain of greedy			*/
+template<typename flat, typename greedy, uint8_t ... bit>
+static bool same_rows(hast::indices<bit...>) {
+	const hast::cycle_t a[] = { (flat::template row<bit>::length
+		^ flat::template row<bit>::rfinish << 16)... };
+	const hast::cycle_t b[] = { (greedy::template t<bit>::length
+		^ greedy::template t<bit>::rfinish << 16)... };
+	for(size_t i = 0; i < sizeof...(bit); ++i)
+		if( a[i] != b[i] ) return false;
+	return true;
+}
+
+/* bursts take the stop bit row, 8N1 only							*/
+template<typename flat, typename greedy, typename uart, bool plain>
+struct flat_burst {
+	static bool same() { return true; }
+};
+template<typename flat, typename greedy, typename uart>
+struct flat_burst<flat, greedy, uart, true> {
+	static bool same() {
+		greedy::init();
+		greedy::send(pattern, length);
+		const hast::cycle_t expected = hast::sim::now();
+		flat::init();
+		flat::send(pattern, length);
+		return hast::sim::now() == expected &&
+			uart::decode(hast::sim::trace(), pattern, length).errors == 0;
+	}
+};
+
+/* flat engine must give the greedy time-table and the same timing of
+ * send and burst												*/
+template<hast::clock_t clock, hast::clock_t baud, typename format>
+static bool check_flat(const char* name) {
+	using greedy = hast::transmitter<clock, baud, line, hast::stopbits::one,
+		hast::timetable::greedy, format>;
+	using flat = hast::transmitter<clock, baud, line, hast::stopbits::one,
+		hast::timetable::flat, format>;
+	using uart = hast::sim::uart<clock, baud, 0, format>;
+	typename format::data_t data[length];
+	for(size_t i = 0; i < length; ++i)
+		data[i] = pattern[i] & ((1U << format::data_bits) - 1);
+	greedy::init();
+	for(auto c : data) greedy::send(c);
+	const hast::cycle_t expected = hast::sim::now();
+	flat::init();
+	for(auto c : data) flat::send(c);
+	auto res = uart::decode(hast::sim::trace(), data, length);
+	bool ok = res.errors == 0 && accurate<uart>(res) &&
+		hast::sim::now() == expected &&
+		same_rows<flat, greedy>(typename hast::make_indices<flat::stop_slot + 1>::type());
+	ok = ok && flat_burst<flat, greedy, uart, format::plain>::same();
+	printf(": %8lu : %6lu : %-5s : %6lld : %5u : %s :\n",
+		static_cast<unsigned long>(clock), static_cast<unsigned long>(baud),
+		name, static_cast<long long>(res.max_error),
+		static_cast<unsigned>(hast::sim::now() / length),
+		ok ? "ok  " : "FAIL");
+	return ok;
+}
+#endif
+
+template<hast::clock_t clock, hast::clock_t baud>
+static unsigned check_formats() {
+	using hast::frame;
+	using hast::parity;
+	using hast::bitorder;
+	return
+		!check_format<clock, baud, frame<5>>("5N1") +
+		!check_format<clock, baud, frame<7, parity::even>>("7E1") +
+		!check_format<clock, baud, frame<7, parity::odd>>("7O1") +
+		!check_format<clock, baud, frame<8, parity::even>>("8E1") +
+		!check_format<clock, baud, frame<8, parity::odd>>("8O1") +
+		!check_format<clock, baud, frame<8, parity::mark>>("8M1") +
+		!check_format<clock, baud, frame<8, parity::space>>("8S1") +
+		!check_format<clock, baud, frame<9>>("9N1") +
+		!check_format<clock, baud, frame<8, parity::none, bitorder::msb>>("8N1m") +
+		!check_format<clock, baud, frame<6, parity::even, bitorder::msb>>("6E1m");
+}
+
+/* the first start edge must follow the write within a bit, a compare
+ * missed by timer::schedule would delay it by a whole timer period	*/
+template<hast::clock_t clock, hast::clock_t baud, uint16_t prescale>
+static bool check_async() {
+	using tx = hast::transmitter<clock, baud, line>;
+	using timer = hast::sim::timer<prescale>;
+	using async = hast::async<tx, timer, 16>;
+	using uart = hast::sim::uart<clock, baud>;
+	async::init();
+	const hast::cycle_t written = hast::sim::now();
+	for(uint8_t c : pattern) async::write(c);
+	timer::template run<async>();
+	auto res = uart::decode(hast::sim::trace(), pattern, length);
+	const vector<hast::cycle_t> got = starts(hast::sim::trace(), double(clock) / baud);
+	const hast::cycle_t first = got.empty() ? -1 : got[0] - written;
+	const bool ok = res.errors == 0 && accurate<uart>(res) &&
+		first >= 0 && first < static_cast<hast::cycle_t>(clock / baud);
+	printf(": %8lu : %6lu : %4u : %6lld : %5lld : %6u : %s :\n",
+		static_cast<unsigned long>(clock), static_cast<unsigned long>(baud),
+		prescale, static_cast<long long>(res.max_error),
+		static_cast<long long>(first),
+		static_cast<unsigned>(hast::sim::now() / length),
+		ok ? "ok  " : "FAIL");
+	return ok;
+}
+
+/* interrupt windows must keep the timing without interrupts and stay
+ * within poll jitter with interrupts taking the whole budget			*/
+template<hast::clock_t clock, hast::clock_t baud, hast::cycle_t budget>
+static bool check_windows() {
+	using tx = hast::transmitter<clock, baud, line>;
+	using timer = hast::sim::timer<1>;
+	using plan = typename tx::template windows<timer, budget>;
+	using uart = hast::sim::uart<clock, baud>;
+	tx::init();
+	for(uint8_t c : pattern) tx::send(c);
+	const hast::cycle_t expected = hast::sim::now();
+	const hast::time_t plain = uart::decode(hast::sim::trace(), pattern, length).max_error;
+	hast::time_t error[2] = { 0, 0 };
+	bool ok = true;
+	for(hast::cycle_t load = 0; load <= budget; ++load) {
+		tx::init();
+		timer::load() = load;
+		timer::blocked() = 0;
+		for(uint8_t c : pattern) tx::template send_interruptible<timer, budget>(c);
+		auto res = uart::decode(hast::sim::trace(), pattern, length);
+		if( res.max_error > error[load != 0] ) error[load != 0] = res.max_error;
+		ok = ok && res.errors == 0 && accurate<uart>(res) &&
+			timer::blocked() <= plan::latency &&
+			(load || (hast::sim::now() == expected && res.max_error == plain));
+	}
+	timer::load() = 0;
+	const hast::time_t jitter = uart::ns(timer::poll_cycles - 1) + 1;
+	ok = ok && error[1] <= plain + jitter;
+	printf(": %8lu : %6lu : %4d : %2u : %6d : %6lld : %6lld : %s :\n",
+		static_cast<unsigned long>(clock), static_cast<unsigned long>(baud),
+		budget, plan::count, plan::latency,
+		static_cast<long long>(error[0]), static_cast<long long>(error[1]),
+		ok ? "ok  " : "FAIL");
+	return ok;
+}
+
+/* pulse-width decoder for waveform specs: a symbol starts with an edge
+ * to spec::first, its pulse width selects the bit					*/
+template<hast::clock_t clock, typename spec>
+static vector<uint8_t> read_pulses(const hast::sim::trace_t& edges, size_t from,
+		hast::time_t& worst) {
+	using uart = hast::sim::uart<clock, 1>;
+	vector<uint8_t> res;
+	uint8_t byte = 0, n = 0;
+	for(size_t i = from; i + 1 < edges.size(); ++i) {
+		if( edges[i].level != spec::first(0) ) continue;
+		const hast::time_t width = uart::ns(edges[i+1].at - edges[i].at);
+		const uint8_t bit = hast::abs(width - spec::pulse(1)) < hast::abs(width - spec::pulse(0));
+		const hast::time_t error = hast::abs(width - spec::pulse(bit));
+		if( error > worst ) worst = error;
+		byte = spec::msb ? (byte << 1) | bit : byte | (bit << n);
+		if( ++n == spec::bits ) {
+			res.push_back(byte);
+			byte = n = 0;
+		}
+	}
+	return res;
+}
+
+/* waveform protocols must decode, edges must stay within tolerance	*/
+template<hast::clock_t clock, typename spec>
+static bool check_pulses(const char* name) {
+	using wave = hast::waveform<clock, line, spec>;
+	wave::init();
+	wave::send(pattern, length);
+	hast::time_t worst = 0;
+	const auto& edges = hast::sim::trace();
+	const size_t from = spec::phases;
+	bool ok = read_pulses<clock, spec>(edges, from, worst)
+		== vector<uint8_t>(pattern, pattern + length) && worst <= spec::tolerance;
+	for(size_t p = 0; p < spec::phases && p + 1 < edges.size(); ++p)
+		ok = ok && hast::abs(hast::sim::uart<clock, 1>::ns(edges[p+1].at - edges[p].at)
+			- spec::length(p)) <= spec::tolerance;
+	printf(": %8lu : %-8s : %6lld : %6u : %s :\n",
+		static_cast<unsigned long>(clock), name, static_cast<long long>(worst),
+		static_cast<unsigned>(hast::sim::now() / length), ok ? "ok  " : "FAIL");
+	return ok;
+}
+
+/* UART frames as a waveform spec, decoded by the ideal UART			*/
+template<hast::clock_t clock, hast::clock_t baud, typename spec, size_t skip = 0>
+static bool check_frames(const char* name) {
+	using wave = hast::waveform<clock, line, spec>;
+	using uart = hast::sim::uart<clock, baud>;
+	wave::init();
+	wave::send(pattern, length);
+	const auto& all = hast::sim::trace();
+	bool ok = all.size() > skip;
+	if( skip ) /* break and mark after break							*/
+		ok = ok && hast::abs(uart::ns(all[1].at - all[0].at) - spec::length(0))
+				<= spec::tolerance
+			&& hast::abs(uart::ns(all[2].at - all[1].at) - spec::length(1))
+				<= spec::tolerance;
+	const hast::sim::trace_t frames(all.begin() + (ok ? skip : 0), all.end());
+	auto res = uart::decode(frames, pattern, length);
+	ok = ok && res.errors == 0 && accurate<uart>(res);
+	printf(": %8lu : %-8s : %6lld : %6u : %s :\n",
+		static_cast<unsigned long>(clock), name, static_cast<long long>(res.max_error),
+		static_cast<unsigned>(hast::sim::now() / length), ok ? "ok  " : "FAIL");
+	return ok;
+}
+
+/* reference, bitwise CRC-16/CCITT-FALSE								*/
+static uint16_t crc16(const vector<uint8_t>& data) {
+	uint16_t crc = 0xFFFF;
+	for(uint8_t c : data) {
+		crc ^= c << 8;
+		for(int i = 0; i < 8; ++i)
+			crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+	}
+	return crc;
+}
+
+/* reference, buffered COBS or SLIP encoding of payload and CRC			*/
+static vector<uint8_t> encode(vector<uint8_t> data, hast::encoding enc) {
+	const uint16_t crc = crc16(data);
+	data.push_back(crc >> 8);
+	data.push_back(crc & 0xFF);
+	vector<uint8_t> out;
+	if( enc == hast::encoding::slip ) {
+		out.push_back(0xC0);
+		for(uint8_t c : data) {
+			if( c == 0xC0 ) { out.push_back(0xDB); out.push_back(0xDC); }
+			else if( c == 0xDB ) { out.push_back(0xDB); out.push_back(0xDD); }
+			else out.push_back(c);
+		}
+		out.push_back(0xC0);
+		return out;
+	}
+	size_t code = 0;
+	out.push_back(1);
+	for(size_t i = 0; i < data.size(); ++i) {
+		if( data[i] == 0 ) {
+			code = out.size();
+			out.push_back(1);
+			continue;
+		}
+		out.push_back(data[i]);
+		if( ++out[code] == 0xFF && i + 1 < data.size() ) {
+			code = out.size();
+			out.push_back(1);
+		}
+	}
+	out.push_back(0);
+	return out;
+}
+
+template<hast::clock_t clock, hast::clock_t baud, hast::encoding enc>
+static bool check_packet(const char* name, const vector<uint8_t>& data) {
+	using tx = hast::transmitter<clock, baud, line>;
+	using uart = hast::sim::uart<clock, baud>;
+	const vector<uint8_t> expected = encode(data, enc);
+	tx::init();
+	hast::packet<tx, enc>::send(data.data(), data.size());
+	auto res = uart::decode(hast::sim::trace(), expected.data(), expected.size());
+	const bool ok = res.errors == 0 && accurate<uart>(res) &&
+		res.frames == expected.size();
+	printf(": %8lu : %6lu : %-4s : %-8s : %4u : %5u : %s :\n",
+		static_cast<unsigned long>(clock), static_cast<unsigned long>(baud),
+		enc == hast::encoding::cobs ? "cobs" : "slip", name,
+		static_cast<unsigned>(expected.size()),
+		hast::packet<tx, enc>::steps_per_frame(), ok ? "ok  " : "FAIL");
+	return ok;
+}
+
+template<hast::encoding enc>
+static unsigned check_packets() {
+	vector<uint8_t> longrun(300, 0x5A);
+	longrun[254] = 0;
+	vector<uint8_t> exact(254, 0xA5);
+	return
+		!check_packet<8000000, hast::_115200, enc>("empty", {}) +
+		!check_packet<8000000, hast::_115200, enc>("zeros", {0, 0, 0}) +
+		!check_packet<8000000, hast::_115200, enc>("mixed",
+			{0x11, 0x00, 0xC0, 0xDB, 0x22, 0x00, 0xDC, 0xDD}) +
+		!check_packet<8000000, hast::_115200, enc>("run 300", longrun) +
+		!check_packet<8000000, hast::_9600, enc>("run 254", exact) +
+		!check_packet<8000000, hast::_9600, enc>("run 300", longrun) +
+		!check_packet<8000000, hast::_921600, enc>("run 254", exact) +
+		!check_packet<8000000, hast::_921600, enc>("run 300", longrun);
+}
+
+/* packet steps alone must give the CRC of the payload and stop the
+ * COBS scan at each zero and after 254 non-zero bytes					*/
+hast::packet_cursor cursor;
+static bool check_steps() {
+	using steps = hast::sim::packet_steps<cursor>;
+	vector<uint8_t> data(600);
+	for(size_t i = 0; i < data.size(); ++i)
+		data[i] = i % 97 == 5 ? 0 : static_cast<uint8_t>(i * 7 + 1);
+	for(size_t i = 300; i < 560; ++i) data[i] = 0x5A;
+	uint16_t crc = 0xFFFF;
+	for(uint8_t c : data) crc = hast::crc16_ccitt(crc, c);
+	cursor = { 0xFFFF, data.data(), data.data(), data.data() + data.size(), 0, 1 };
+	for(size_t i = 0; i <= data.size(); ++i) steps::crc();
+	bool ok = cursor.crc == crc && cursor.crc_at == cursor.end;
+	size_t pos = 0;
+	while( ok && pos < data.size() ) {
+		size_t len = 0;
+		while( pos + len < data.size() && len < 254 && data[pos + len] ) ++len;
+		for(size_t i = 0; i <= len; ++i) steps::scan();
+		const bool at_end = pos + len == data.size();
+		ok = cursor.run == len && cursor.open == at_end &&
+			cursor.scan_at == data.data() + pos + len;
+		pos += len + (! at_end && len < 254);
+		cursor.scan_at = data.data() + pos;
+		cursor.run = 0;
+		cursor.open = 1;
+	}
+	printf(": %8s : %6s : step : cursor   : %4u :       : %s :\n", "-", "-",
+		static_cast<unsigned>(data.size()), ok ? "ok  " : "FAIL");
+	return ok;
+}
+
+/* log record is an ID and raw little endian arguments in a COBS packet	*/
+static bool check_log() {
+	using tx = hast::transmitter<8000000, hast::_921600, line>;
+	using uart = hast::sim::uart<8000000, hast::_921600>;
+	const vector<uint8_t> expected = encode(
+		{ 0x34, 0x12, 0x07, 0xD4, 0xFE, 0x40, 0xE2, 0x01, 0x00 },
+		hast::encoding::cobs);
+	tx::init();
+	hast::log<tx>::write(0x1234, uint8_t(7), int16_t(-300), uint32_t(123456));
+	const bool ok = uart::read(hast::sim::trace()) == expected;
+	printf(": %8lu : %6lu : log  : record   : %4u :       : %s :\n",
+		8000000UL, static_cast<unsigned long>(hast::_921600),
+		static_cast<unsigned>(expected.size()), ok ? "ok  " : "FAIL");
+	return ok;
+}
+
+/* pre-encoded flash string must keep the timing of burst from RAM		*/
+/* hast_log must find a HAST_LOG string in the ELF of this program and
+ * render the record sent on the line. A PIE build adds the load address
+ * to the ID, then the string is looked up by its text				*/
+static bool check_log_elf(const char* self) {
+	using tx = hast::transmitter<8000000, hast::_921600, line>;
+	using dbg = hast::log<tx>;
+	static const char text[] = "adc=%u t=%lu";
+	tx::init();
+	HAST_LOG(dbg, "adc=%u t=%lu", uint32_t(513), static_cast<unsigned long>(123456));
+	vector<char> strings;
+	abi target;
+	bool ok = load(self, strings, target);
+	vector<uint8_t> packet = hast::sim::uart<8000000, hast::_921600>::read(
+		hast::sim::trace());
+	ok = ok && packet.size() > 1 && packet.back() == 0;
+	if( ok ) packet.pop_back();
+	ok = ok && unstuff(packet) && packet.size() >= 4 &&
+		crc16(packet.data(), packet.size() - 2) ==
+			((packet[packet.size()-2] << 8) | packet.back());
+	size_t id = ok ? le(packet.data(), 2) : 0;
+#ifdef __PIE__
+	id = 0;
+	while( id < strings.size() && strcmp(&strings[id], text) ) ++id;
+#endif
+	ok = ok && id < strings.size() && ! strcmp(&strings[id], text) &&
+		render(&strings[id], &packet[2], packet.size() - 4, target)
+			== "adc=513 t=123456";
+	printf(": %-8s : %-22s : %s :\n", "elf", self, ok ? "ok  " : "FAIL");
+	return ok;
+}
+
+/* render must size arguments as the target does, int is 2 bytes on AVR	*/
+static unsigned check_render() {
+	static const abi avr = { 2, 4, 4, 2 };
+	const float pi = 3.14159f;
+	uint8_t real[4];
+	memcpy(real, &pi, 4);
+	struct {
+		const char* fmt;
+		vector<uint8_t> args;
+		const char* text;
+	} cases[] = {
+		{ "%u",		{ 0x34, 0x12 },					"4660" },
+		{ "%d",		{ 0xD4, 0xFE },					"-300" },
+		{ "%hhu%c",	{ 7, 'A' },						"7A" },
+		{ "%lu",	{ 0x40, 0xE2, 0x01, 0x00 },		"123456" },
+		{ "%lld",	{ 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF }, "-1" },
+		{ "%04x",	{ 0xAB, 0x00 },					"00ab" },
+		{ "%5.2f",	{ real[0], real[1], real[2], real[3] }, " 3.14" },
+		{ "100%%",	{},								"100%" },
+		{ "s=%s",	{ 'a', 0 },						"s=<?>" },
+		{ "%lu",	{ 0x01, 0x02 },					"<?>" }
+	};
+	unsigned failed = 0;
+	for(const auto& c : cases) {
+		const string got = render(c.fmt, c.args.data(), c.args.size(), avr);
+		const bool ok = got == c.text;
+		printf(": %-8s : %-22s : %s :\n", "render", c.fmt, ok ? "ok  " : "FAIL");
+		failed += ! ok;
+	}
+	return failed;
+}
+
+template<hast::clock_t clock, hast::clock_t baud>
+static bool check_flash() {
+	using tx = hast::transmitter<clock, baud, line>;
+	using uart = hast::sim::uart<clock, baud>;
+	static const char text[] = "HAST \x80\xFF\x01";
+	const auto str = HAST_STR("HAST \x80\xFF\x01");
+	const uint8_t* expected = reinterpret_cast<const uint8_t*>(text);
+	tx::init();
+	tx::send(expected, str.size);
+	const hast::sim::trace_t burst = hast::sim::trace();
+	tx::init();
+	tx::send_P(str);
+	const hast::sim::trace_t& flash = hast::sim::trace();
+	auto res = uart::decode(flash, expected, str.size);
+	bool same = burst.size() == flash.size();
+	for(size_t i = 0; same && i < burst.size(); ++i)
+		same = burst[i].at - burst[0].at == flash[i].at - flash[0].at
+			|| tx::burst::gap < 0;
+	const bool ok = res.errors == 0 && accurate<uart>(res) && same &&
+		paced<tx>(flash, str.size, tx::burst_P::gap);
+	printf(": %8lu : %6lu : %6lld : %5d : %5d : %s :\n",
+		static_cast<unsigned long>(clock), static_cast<unsigned long>(baud),
+		static_cast<long long>(res.max_error),
+		tx::burst::gap, tx::burst_P::gap, ok ? "ok  " : "FAIL");
+	return ok;
+}
+
+/* RS-485 DE must rise lead cycles before the start edge and fall at the
+ * end of the stop bit period, frames must keep the plain driver timing.
+ * lead must cover the enable time, and by less than one cycle			*/
+
+template<hast::clock_t clock, hast::clock_t baud, hast::time_t enable_ns>
+static bool check_rs485() {
+	using drv = hast::sim::rs485_driver<34,33,32,11,10,5,clock,enable_ns>;
+	static constexpr hast::cycle_t lead = drv::lead;
+	using ref = hast::transmitter<clock, baud, line>;
+	using tx = hast::transmitter<clock, baud, drv>;
+	using uart = hast::sim::uart<clock, baud>;
+	static constexpr hast::cycle_t wait = tx::template t<tx::stop_slot>::wait;
+	static constexpr hast::cycle_t late =
+		wait < drv::done_cycles ? drv::done_cycles - wait : 0;
+	const double bit = double(clock) / baud;
+	const hast::sim::trace_t& de = hast::sim::pin_trace(11, 5);
+	const hast::time_t lead_ns = lead * hast::nano / clock;
+	bool ok = lead_ns >= enable_ns && (enable_ns == 0 ? lead == 1
+		: (lead - 1) * hast::nano / clock < enable_ns);
+	hast::time_t max_error = 0;
+	for(size_t i = 0; i <= length; ++i) {
+		const uint8_t* data = i < length ? &pattern[i] : pattern;
+		const uint8_t n = i < length ? 1 : length;
+		ref::init();
+		if( n == 1 ) ref::send(*data); else ref::send(data, n);
+		const vector<hast::cycle_t> expect = starts(hast::sim::trace(), bit);
+		/* plain driver: stop period ends one cycle (out SREG) earlier	*/
+		const hast::cycle_t end = hast::sim::now() - 1 - expect.back();
+		tx::init();
+		if( n == 1 ) tx::send(*data); else tx::send(data, n);
+		const vector<hast::cycle_t> got = starts(hast::sim::trace(), bit);
+		auto res = uart::decode(hast::sim::trace(), data, n);
+		if( res.max_error > max_error ) max_error = res.max_error;
+		ok = ok && res.errors == 0 && accurate<uart>(res) &&
+			got.size() == n && expect.size() == n &&
+			de.size() == 2 && de[0].level == 1 && de[1].level == 0 &&
+			got[0] - de[0].at == lead && de[1].at - got.back() == end + late;
+		for(size_t k = 1; ok && k < got.size(); ++k)
+			ok = got[k] - got[0] == expect[k] - expect[0];
+	}
+	printf(": %8lu : %6lu : %7lld : %4lu : %6lld : %6lld : %4lld : %s :\n",
+		static_cast<unsigned long>(clock), static_cast<unsigned long>(baud),
+		static_cast<long long>(enable_ns), static_cast<unsigned long>(lead),
+		static_cast<long long>(max_error), static_cast<long long>(lead_ns),
+		static_cast<long long>(late), ok ? "ok  " : "FAIL");
+	return ok;
+}
+
+/* with burst_wait, CTS deasserted before a frame of a burst must hold
+ * the start edge and start it within cts_poll_cycles + 3 (sbic, andi,
+ * out) after CTS. Without it, the burst must keep its timing			*/
+template<hast::clock_t clock, hast::clock_t baud, bool burst_wait>
+static bool check_cts() {
+	using drv = hast::sim::cts_driver<34,33,32,35,1,burst_wait>;
+	using tx = hast::transmitter<clock, baud, drv>;
+	using uart = hast::sim::uart<clock, baud>;
+	static constexpr size_t held = 6;
+	const double bit = double(clock) / baud;
+	tx::init();
+	drv::deassert(0, 0);
+	tx::send(pattern, length);
+	const vector<hast::cycle_t> expect = starts(hast::sim::trace(), bit);
+	const hast::cycle_t until = expect[held] + static_cast<hast::cycle_t>(3 * bit);
+	tx::init();
+	drv::deassert(expect[held - 1] + 1, until);
+	tx::send(pattern, length);
+	drv::deassert(0, 0);
+	const vector<hast::cycle_t> got = starts(hast::sim::trace(), bit);
+	auto res = uart::decode(hast::sim::trace(), pattern, length);
+	bool ok = res.errors == 0 && accurate<uart>(res) &&
+		got.size() == length && expect.size() == length;
+	const hast::cycle_t latency = ! ok ? -1 : burst_wait ? got[held] - until : 0;
+	ok = ok && latency >= 0 && latency <= drv::cts_poll_cycles + 3;
+	for(size_t k = 1; ok && k < length; ++k)
+		ok = k < held || ! burst_wait ? got[k] == expect[k]
+			: got[k] - got[held] == expect[k] - expect[held];
+	printf(": %8lu : %6lu : %s : %6lld : %5lld : %5d : %s :\n",
+		static_cast<unsigned long>(clock), static_cast<unsigned long>(baud),
+		burst_wait ? "yes " : "no  ", static_cast<long long>(res.max_error),
+		static_cast<long long>(latency), tx::burst::gap, ok ? "ok  " : "FAIL");
+	return ok;
+}
+
+using input = hast::sim::input<>;
+
+/* append the edges of an 8N1 frame of the value, bit in milicycles	*/
+static void stimulate(hast::cycle_t at, hast::milicycle_t bit, uint8_t value) {
+	uint8_t level = input::mark;
+	for(uint8_t k = 0; k < 10; ++k) {
+		const uint8_t next = k == 0 ? !input::mark : k == 9 ? input::mark
+			: (value >> (k - 1)) & 1;
+		if( next != level )
+			input::stimulus().push_back(hast::sim::edge{
+				at + static_cast<hast::cycle_t>((k * bit) / hast::mili), next});
+		level = next;
+	}
+}
+
+/* receiver must decode every value at three phases of the start edge
+ * with the sender off by -2%, 0 and +2%; slack is the least number of
+ * cycles left from the return to the end of the stop bit, negative at
+ * CLOCK/8. A SPACE pulse of 3/8 bit must be rejected before the frame
+ * that follows it two bits later, and that frame must decode			*/
+template<hast::clock_t clock, hast::clock_t baud>
+static bool check_receive() {
+	using rx = hast::receiver<clock, baud, input>;
+	static constexpr hast::milicycle_t bit = rx::milicycles_per_bit;
+	unsigned frames = 0, errors = 0;
+	hast::cycle_t slack = rx::template r<8>::rfinish;
+	for(int dev = -20; dev <= 20; dev += 20)
+		for(hast::cycle_t phase = 0; phase < 3; ++phase)
+			for(unsigned value = 0; value < 256; ++value) {
+				const hast::milicycle_t len = bit * (1000 + dev) / 1000;
+				const hast::cycle_t at = 10 + phase;
+				uint8_t data;
+				rx::init();
+				stimulate(at, len, value);
+				const bool ok = rx::receive(data) && data == value;
+				const hast::cycle_t left = at + static_cast<hast::cycle_t>(
+					(10 * len) / hast::mili) - hast::sim::now();
+				if( left < slack ) slack = left;
+				++frames;
+				errors += ! ok;
+			}
+	bool glitch = true;
+	for(hast::cycle_t phase = 0; phase < 3; ++phase) {
+		const hast::cycle_t at = 10 + phase;
+		const hast::cycle_t next = at + (2 * bit) / hast::mili;
+		uint8_t data;
+		rx::init();
+		input::stimulus().push_back(hast::sim::edge{at, !input::mark});
+		input::stimulus().push_back(hast::sim::edge{at +
+			static_cast<hast::cycle_t>((3 * bit) / (8 * hast::mili)), input::mark});
+		stimulate(next, bit, 0x5A);
+		glitch = glitch && ! rx::receive(data) && hast::sim::now() < next
+			&& rx::receive(data) && data == 0x5A;
+	}
+	const bool ok = errors == 0 && glitch;
+	printf(": %8lu : %7lu : %5u : %5d : %5u : %5u : %s : %s :\n",
+		static_cast<unsigned long>(clock), static_cast<unsigned long>(baud),
+		static_cast<unsigned>(rx::rs::rpoint), slack, frames, errors,
+		glitch ? "ok  " : "FAIL", ok ? "ok  " : "FAIL");
+	return ok;
+}
+
+/* multi_transmitter must switch baudrate and clock with select() and
+ * keep the selection on indexes out of range							*/
+using multi = hast::multi_transmitter<hast::clocks<8000000, 16000000>,
+	hast::bauds<hast::_19200, hast::_115200, hast::_921600>, line>;
+
+template<hast::clock_t clock, hast::clock_t baud>
+static bool check_multi() {
+	using uart = hast::sim::uart<clock, baud>;
+	static constexpr uint8_t index = multi::index_of(clock, baud);
+	static_assert(index < multi::count, "Combination is not in the lists");
+	multi::init();
+	bool ok = multi::select(index) && ! multi::select(multi::count)
+		&& ! multi::select(2, 0) && ! multi::select(0, 3);
+	for(uint8_t c : pattern) multi::send(c);
+	auto res = uart::decode(hast::sim::trace(), pattern, length);
+	ok = ok && res.errors == 0 && accurate<uart>(res);
+	printf(": %8lu : %6lu : %u : %6lld : %5u : %s :\n",
+		static_cast<unsigned long>(clock), static_cast<unsigned long>(baud),
+		index, static_cast<long long>(res.max_error),
+		static_cast<unsigned>(hast::sim::now() / length),
+		ok ? "ok  " : "FAIL");
+	return ok;
+}
+
+/* parallel channels must decode on pins 0, 1 and 3 of one port		*/
+template<hast::clock_t clock, hast::clock_t baud>
+static bool check_parallel() {
+	using tx = hast::parallel<clock, baud, hast::sim::parallel_driver<5,4,0x0B>>;
+	using uart = hast::sim::uart<clock, baud>;
+	static const uint8_t pins[] = { 0, 1, 3 };
+	uint8_t expect[3][length];
+	tx::init();
+	for(size_t i = 0; i < length; ++i) {
+		const uint8_t data[3] = { pattern[i], pattern[(i + 3) % length],
+			pattern[(i + 7) % length] };
+		for(uint8_t c = 0; c < 3; ++c) expect[c][i] = data[c];
+		tx::send(data);
+	}
+	bool ok = true;
+	hast::time_t worst = 0;
+	for(uint8_t c = 0; c < 3; ++c) {
+		auto res = uart::decode(hast::sim::pin_trace(5, pins[c]), expect[c], length);
+		ok = ok && res.errors == 0 && res.frames == length && accurate<uart>(res);
+		if( res.max_error > worst ) worst = res.max_error;
+	}
+	printf(": %8lu : %6lu : %6lld : %5u : %s :\n",
+		static_cast<unsigned long>(clock), static_cast<unsigned long>(baud),
+		static_cast<long long>(worst),
+		static_cast<unsigned>(hast::sim::now() / length), ok ? "ok  " : "FAIL");
+	return ok;
+}
+
+/* interleaved channels must decode and take the longest frame only	*/
+template<hast::clock_t clock, hast::clock_t b0, hast::clock_t b1, hast::clock_t b2>
+static bool check_interleaved() {
+	using tx = hast::interleaved<clock,
+		hast::channel<b0, hast::sim::driver<5,4,3>>,
+		hast::channel<b1, hast::sim::driver<5,4,4>>,
+		hast::channel<b2, hast::sim::driver<11,10,2>, hast::stopbits::two>>;
+	static constexpr hast::cycle_t expected = tx::tail
+		+ tx::template t<tx::events - 1>::rfinish - tx::t0::rfinish;
+	uint8_t expect[3][length];
+	bool timed = true;
+	tx::init();
+	for(size_t i = 0; i < length; ++i) {
+		uint8_t data[3] = { pattern[i], pattern[(i + 3) % length],
+			pattern[(i + 7) % length] };
+		for(uint8_t c = 0; c < 3; ++c) expect[c][i] = data[c];
+		const hast::cycle_t from = hast::sim::now();
+		tx::send(data);
+		timed = timed && hast::sim::now() - from == expected;
+	}
+	auto r0 = hast::sim::uart<clock, b0>::decode(hast::sim::pin_trace(5, 3), expect[0], length);
+	auto r1 = hast::sim::uart<clock, b1>::decode(hast::sim::pin_trace(5, 4), expect[1], length);
+	auto r2 = hast::sim::uart<clock, b2>::decode(hast::sim::pin_trace(11, 2), expect[2], length);
+	const hast::cycle_t frames = (tx::finish(0) + tx::finish(1) + tx::finish(2)) / hast::mili;
+	const bool ok = timed && r0.errors == 0 && r1.errors == 0 && r2.errors == 0
+		&& accurate<hast::sim::uart<clock, b0>>(r0)
+		&& accurate<hast::sim::uart<clock, b1>>(r1)
+		&& accurate<hast::sim::uart<clock, b2>>(r2);
+	printf(": %8lu : %6lu : %6lu : %6lu : %6lld : %6lld : %6lld : %6u : %6u : %s :\n",
+		static_cast<unsigned long>(clock), static_cast<unsigned long>(b0),
+		static_cast<unsigned long>(b1), static_cast<unsigned long>(b2),
+		static_cast<long long>(r0.max_error), static_cast<long long>(r1.max_error),
+		static_cast<long long>(r2.max_error), static_cast<unsigned>(expected),
+		static_cast<unsigned>(frames), ok ? "ok  " : "FAIL");
+	return ok;
+}
+
+/* baudrates the library accepts at the clock, with both stop bit settings */
+template<hast::clock_t clock, hast::clock_t ... baud>
+static unsigned check_clock() {
+	unsigned failed = 0;
+	using expand = int[];
+	(void) expand { 0, (failed +=
+		!check<clock, baud, hast::stopbits::one>() +
+		!check<clock, baud, hast::stopbits::two>(), 0)... };
+	return failed;
+}
+
+int main(int argc, char** argv) {
+	if( argc > 1 ) vcd = fopen(argv[1], "w");
+	printf(":   clock  :  baud  :sb: single : burst  :cyc/B :cyc/B :      :\n");
+	printf(":          :        :  :  err ns: err ns :single:burst :      :\n");
+	printf(":----------:--------:--:--------:--------:------:------:------:\n");
+	unsigned failed =
+		check_clock<1000000, hast::_9600, hast::_19200, hast::_38400,
+			hast::_57600, hast::_115200, hast::_230400>() +
+		check_clock<4000000, hast::_9600, hast::_19200, hast::_38400,
+			hast::_57600, hast::_115200, hast::_230400, hast::_460800,
+			hast::_921600>() +
+		check_clock<8000000, hast::_9600, hast::_19200, hast::_38400,
+			hast::_57600, hast::_115200, hast::_230400, hast::_460800,
+			hast::_921600>() +
+		check_clock<16000000, hast::_19200, hast::_38400, hast::_57600,
+			hast::_115200, hast::_230400, hast::_460800, hast::_921600>() +
+		check_clock<20000000, hast::_19200, hast::_38400, hast::_57600,
+			hast::_115200, hast::_230400, hast::_460800, hast::_921600>();
+	printf("\ntoggle driver\n");
+	failed +=
+		!check<1000000, 250000, hast::stopbits::one, toggle>() +
+		!check<8000000, hast::_921600, hast::stopbits::one, toggle>() +
+		!check<8000000, 3000000, hast::stopbits::one, toggle>() +
+		!check<16000000, 8000000, hast::stopbits::one, toggle>() +
+		!check<20000000, 8000000, hast::stopbits::two, toggle>();
+	printf("\npreloaded driver\n");
+	failed +=
+		!check<8000000, hast::_921600, hast::stopbits::one, preload>() +
+		!check<8000000, 4000000, hast::stopbits::one, preload>() +
+		!check<8000000, 8000000, hast::stopbits::one, preload>() +
+		!check<16000000, 2000000, hast::stopbits::one, preload>() +
+		!check_format<8000000, hast::_115200, hast::frame<7, hast::parity::even>, preload>("7E1") +
+		!check_format<8000000, 1000000, hast::frame<7, hast::parity::even>, preload>("7E1") +
+		!check_format<16000000, 2000000, hast::frame<7, hast::parity::odd>, preload>("7O1") +
+		!check_values<8000000, hast::_115200, hast::frame<7, hast::parity::even>, preload>("7E1") +
+		!check_values<8000000, hast::_115200, hast::frame<7, hast::parity::odd>, preload>("7O1") +
+		!check_values<16000000, 2000000, hast::frame<6, hast::parity::odd>, preload>("6O1") +
+		!check_values<8000000, hast::_115200, hast::frame<7, hast::parity::even>>("7E1") +
+		!check_values<8000000, hast::_115200, hast::frame<5, hast::parity::odd>>("5O1");
+	printf("\n:   clock  :  baud  : err ns : gap  :gap P : flash:\n");
+	printf(":----------:--------:--------:------:------:------:\n");
+	failed +=
+		!check_flash<1000000, hast::_57600>() +
+		!check_flash<8000000, hast::_115200>() +
+		!check_flash<8000000, hast::_921600>() +
+		!check_flash<16000000, hast::_921600>() +
+		!check_flash<20000000, 2000000>();
+	printf("\n:   clock  :  baud  :enable ns: lead : err ns :lead ns : late :RS-485:\n");
+	printf(":----------:--------:---------:------:--------:--------:------:------:\n");
+	failed +=
+		!check_rs485<1000000, hast::_9600, 0>() +
+		!check_rs485<8000000, hast::_115200, 0>() +
+		!check_rs485<8000000, hast::_115200, 1000>() +
+		!check_rs485<16000000, hast::_921600, 200>() +
+		!check_rs485<20000000, 2000000, 70>();
+	printf("\n:   clock  :  baud  : wait : err ns :latcy : gap  : CTS  :\n");
+	printf(":----------:--------:------:--------:------:------:------:\n");
+	failed +=
+		!check_cts<1000000, hast::_9600, true>() +
+		!check_cts<8000000, hast::_115200, true>() +
+		!check_cts<8000000, hast::_115200, false>() +
+		!check_cts<8000000, hast::_921600, true>() +
+		!check_cts<16000000, hast::_921600, true>() +
+		!check_cts<20000000, 2000000, true>() +
+		!check_cts<20000000, 2000000, false>();
+	printf("\n:   clock  :  baud   : check : slack :frames :errors :glitch:  rx  :\n");
+	printf(":          :         : cycle : cycles:       :       :      :      :\n");
+	printf(":----------:---------:-------:-------:-------:-------:------:------:\n");
+	failed +=
+		!check_receive<1000000, hast::_9600>() +
+		!check_receive<8000000, hast::_115200>() +
+		!check_receive<8000000, 1000000>() +
+		!check_receive<16000000, hast::_921600>() +
+		!check_receive<20000000, 2000000>();
+	printf("\n:   clock  :  baud  :# : err ns :cyc/B :multi :\n");
+	printf(":----------:--------:--:--------:------:------:\n");
+	failed +=
+		!check_multi<8000000, hast::_19200>() +
+		!check_multi<8000000, hast::_921600>() +
+		!check_multi<16000000, hast::_115200>() +
+		!check_multi<16000000, hast::_921600>() +
+		!check_multi<8000000, hast::_115200>();
+	printf("\n:   clock  :  baud  :b : err ns :report : words :words :compact\n");
+	printf(":          :        :  :        :err ns :unroll :loop  :      :\n");
+	printf(":----------:--------:--:--------:-------:-------:------:------:\n");
+	failed +=
+		!check_compact<1000000, hast::_9600>() +
+		!check_compact<1000000, hast::_57600>() +
+		!check_compact<8000000, hast::_115200>() +
+		!check_compact<8000000, hast::_230400>() +
+		!check_compact<8000000, hast::_460800>() +
+		!check_compact<16000000, hast::_921600>() +
+		!check_compact<8000000, hast::_115200, hast::frame<9>>() +
+		!check_compact<8000000, hast::_115200, hast::frame<7, hast::parity::even>>() +
+		!check_compact<16000000, hast::_921600, hast::frame<>, toggle>();
+	printf("\n:   clock  :  baud  :format : err ns :cyc/B :      :\n");
+	printf(":----------:--------:-------:--------:------:------:\n");
+	failed +=
+		check_formats<1000000, hast::_115200>() +
+		check_formats<8000000, hast::_115200>() +
+		check_formats<8000000, hast::_921600>() +
+		check_formats<16000000, hast::_921600>();
+#if __cplusplus >= 201402L
+	printf("\n:   clock  :  baud  :format : err ns :cyc/B : flat :\n");
+	printf(":----------:--------:-------:--------:------:------:\n");
+	failed +=
+		!check_flat<1000000, hast::_9600, hast::frame<>>("8N1") +
+		!check_flat<8000000, hast::_115200, hast::frame<5>>("5N1") +
+		!check_flat<8000000, hast::_921600, hast::frame<7, hast::parity::even>>("7E1") +
+		!check_flat<16000000, hast::_230400, hast::frame<8, hast::parity::odd>>("8O1") +
+		!check_flat<16000000, hast::_921600, hast::frame<9>>("9N1");
+#endif
+	printf("\n:   clock  :  baud  :presc.: err ns :start : cyc/B  :async :\n");
+	printf(":----------:--------:------:--------:------:--------:------:\n");
+	failed +=
+		!check_async<1000000, hast::_9600, 8>() +
+		!check_async<8000000, hast::_57600, 1>() +
+		!check_async<8000000, hast::_9600, 64>() +
+		!check_async<8000000, hast::_19200, 8>() +
+		!check_async<8000000, hast::_57600, 8>() +
+		!check_async<16000000, hast::_57600, 8>();
+	printf("\n:   clock  :  baud  :budget:# :latency: err ns : err ns :window:\n");
+	printf(":          :        :      :  :  cyc  :  idle  : loaded :      :\n");
+	printf(":----------:--------:------:--:-------:--------:--------:------:\n");
+	failed +=
+		!check_windows<1000000, hast::_9600, 40>() +
+		!check_windows<8000000, hast::_9600, 80>() +
+		!check_windows<8000000, hast::_19200, 60>() +
+		!check_windows<8000000, hast::_57600, 60>() +
+		!check_windows<16000000, hast::_38400, 100>() +
+		!check_windows<16000000, hast::_115200, 60>();
+	printf("\n:   clock  : protocol : err ns : cyc/B  : wave :\n");
+	printf(":----------:----------:--------:--------:------:\n");
+	failed +=
+		!check_pulses<8000000, hast::protocol::ws2812>("ws2812") +
+		!check_pulses<16000000, hast::protocol::ws2812>("ws2812") +
+		!check_pulses<20000000, hast::protocol::ws2812>("ws2812") +
+		!check_pulses<1000000, hast::protocol::onewire>("1-wire") +
+		!check_pulses<16000000, hast::protocol::onewire>("1-wire") +
+		!check_frames<8000000, 250000, hast::protocol::dmx512, 2>("dmx512") +
+		!check_frames<16000000, 250000, hast::protocol::dmx512, 2>("dmx512") +
+		!check_frames<8000000, hast::_115200,
+			hast::protocol::uart<hast::_115200>>("uart") +
+		!check_frames<16000000, hast::_921600,
+			hast::protocol::uart<hast::_921600>>("uart");
+	printf("\n:   clock  :  baud  : err ns :cyc/B :paral.:\n");
+	printf(":----------:--------:--------:------:------:\n");
+	failed +=
+		!check_parallel<1000000, hast::_9600>() +
+		!check_parallel<8000000, hast::_115200>() +
+		!check_parallel<8000000, hast::_921600>() +
+		!check_parallel<16000000, hast::_921600>() +
+		!check_parallel<20000000, 2000000>();
+	printf("\n:   clock  : baud 0 : baud 1 : baud 2 : err ns : err ns : err ns : cyc/tx :  sum   :inter.:\n");
+	printf(":----------:--------:--------:--------:--------:--------:--------:--------:--------:------:\n");
+	failed +=
+		!check_interleaved<1000000, hast::_9600, hast::_19200, 4800>() +
+		!check_interleaved<8000000, hast::_9600, hast::_115200, hast::_57600>() +
+		!check_interleaved<8000000, hast::_115200, hast::_115200, hast::_115200>() +
+		!check_interleaved<16000000, hast::_115200, hast::_230400, hast::_38400>() +
+		!check_interleaved<20000000, hast::_57600, 250000, hast::_19200>();
+	printf("\n:   clock  :  baud  : enc  : payload  : size : steps :packet:\n");
+	printf(":----------:--------:------:----------:------:-------:------:\n");
+	failed +=
+		!check_steps() +
+		check_packets<hast::encoding::cobs>() +
+		check_packets<hast::encoding::slip>() +
+		!check_log();
+	printf("\n: hast_log : case                   : tool :\n");
+	printf(":----------:------------------------:------:\n");
+	failed +=
+		!check_log_elf(argv[0]) +
+		check_render();
+	printf("%u configuration(s) failed\n", failed);
+	return failed != 0;
+}
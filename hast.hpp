@@ -27,6 +27,10 @@
 #include <stdint.h> //TODO change to cstdint when it becomes available
 #ifdef __AVR__
 #	include <avr/io.h>
+#	include <avr/pgmspace.h>
+#	define HAST_PROGMEM PROGMEM	/* tables are kept in flash			*/
+#else
+#	define HAST_PROGMEM
 #endif
 
 #if __cplusplus <  201103L 
@@ -41,6 +45,45 @@
 #	define static_warn(a,b) static_assert(a,b)
 #endif
 
+/* Section for HAST_LOG format strings, not allocated in the target memory.
+ * GCC writes the name into a .section directive and appends its own flags,
+ * the name given here sets empty flags and comments out the rest of the
+ * line. This relies on GCC with GNU as for ELF and on the comment character
+ * of the target: ';' on AVR, '@' on ARM (type is %progbits there), '//' on
+ * AArch64, '#' elsewhere (x86, RISC-V). With other toolchains define
+ * HAST_LOG_SECTION as ".hast_log" and keep it out of memory with -T of:
+ *   SECTIONS { .hast_log 0 (INFO) : { KEEP(*(.hast_log)) } }
+ *   INSERT AFTER .comment;
+ * The ID is the string's address, its offset when the section is at 0	*/
+#ifndef HAST_LOG_SECTION
+#	if defined(__AVR__)
+#		define HAST_LOG_SECTION ".hast_log,\"\",@progbits ;"
+#	elif defined(__arm__)
+#		define HAST_LOG_SECTION ".hast_log,\"\",%progbits @"
+#	elif defined(__aarch64__)
+#		define HAST_LOG_SECTION ".hast_log,\"\",@progbits //"
+#	else
+#		define HAST_LOG_SECTION ".hast_log,\"\",@progbits #"
+#	endif
+#endif
+
+/** Deferred log record, e.g. HAST_LOG(dbg, "adc %u at %lu", adc, millis)	*/
+#define HAST_LOG(logger, fmt, ...) do {										\
+	static const char hast_log_fmt[]										\
+		__attribute__((section(HAST_LOG_SECTION), used)) = fmt;				\
+	logger::write(reinterpret_cast<uintptr_t>(hast_log_fmt), ##__VA_ARGS__);\
+} while(0)
+
+/** String literal pre-encoded for transmitter::send_P, kept in flash,
+ *  e.g. tx::send_P(HAST_STR("Hello"))										*/
+#define HAST_STR(s) ([] {													\
+	struct hast_str {														\
+		static constexpr const char* text() { return s; }					\
+		static constexpr uint8_t size() { return sizeof(s) - 1; }			\
+	};																		\
+	return ::hast::flash_string<hast_str>();								\
+}())
+
 /*  Video instructions are available at 
     https://www.youtube.com/watch?v=W3q8Od5qJio								*/
 
@@ -90,8 +133,138 @@ namespace hast {
 
 	template<template<uint8_t> class A, class B>
 	struct prev<0,A,B> : B {};
+
+	/* index list for unrolling over a pack								*/
+	template<uint8_t ... i>
+	struct indices {};
+	template<uint8_t n, uint8_t ... i>
+	struct make_indices : make_indices<n-1, n-1, i...> {};
+	template<uint8_t ... i>
+	struct make_indices<0, i...> { using type = indices<i...>; };
+
+	/** Time-table engines
+	 * greedy	- rounds each bit to the nearest cycle, from bit 0 forward
+	 * minimax	- chooses all data edges together to minimise the maximum
+	 *			  sampling-point (mid-bit) error across the frame
+	 * flat		- same as greedy, computed by one constexpr function as an
+	 *			  array instead of a chain of instantiations (C++14)		*/
+	enum class timetable : uint8_t {
+		greedy,
+		minimax,
+		flat
+	};
+
+	/** time-table engine, provides bit lengths for transmitter::t<bit>	*/
+	template<typename tx, timetable engine>
+	struct schedule;
+
+	/** Parity bit modes													*/
+	enum class parity : uint8_t {
+		none,
+		even,
+		odd,
+		mark,		/** parity bit is always 1								*/
+		space		/** parity bit is always 0								*/
+	};
+
+	/** Bit order on the wire												*/
+	enum class bitorder : uint8_t {
+		lsb,		/** least significant bit first (standard UART)			*/
+		msb
+	};
+
+	/* unsigned type wide enough for the given number of bits				*/
+	template<bool wide>
+	struct word { using type = uint8_t; };
+	template<>
+	struct word<true> { using type = uint16_t; };
+
+	/** UART frame format
+	  * params
+	  *   databits	- number of data bits, 5..9
+	  *   par		- parity mode
+	  *   order		- bit order
+	  *																		*/
+	template<uint8_t databits = 8, parity par = parity::none,
+		bitorder order = bitorder::lsb>
+	struct frame {
+		using data_t = typename word<(databits > 8)>::type;
+		static constexpr uint8_t data_bits = databits;
+		static constexpr parity parity_mode = par;
+		static constexpr bitorder bit_order = order;
+		/** bits between start and stop								*/
+		static constexpr uint8_t bits = databits + (par == parity::none ? 0 : 1);
+		/** parity computed at run time (even/odd)						*/
+		static constexpr bool computed = par == parity::even || par == parity::odd;
+		/** plain 8N1 frame, data goes to the wire as is				*/
+		static constexpr bool plain = databits == 8 && par == parity::none
+			&& order == bitorder::lsb;
+
+		/* reverse order of the lowest n bits							*/
+		static constexpr uint16_t reverse(uint16_t data, uint8_t n) {
+			return n == 0 ? 0 : ((data & 1) << (n-1)) | reverse(data >> 1, n - 1);
+		}
+		/* parity of the lowest n bits									*/
+		static constexpr uint8_t odd_bits(uint16_t data, uint8_t n) {
+			return n == 0 ? 0 : (data & 1) ^ odd_bits(data >> 1, n - 1);
+		}
+		/** frame bits in transmit order, f0 first, without start/stop	*/
+		static constexpr uint16_t wire(uint16_t data, bool with_parity) {
+			return (order == bitorder::msb
+					? reverse(data, databits)
+					: data & ((1U << databits) - 1))
+				| ((par == parity::mark ||
+				   (with_parity && (par == parity::even || par == parity::odd) &&
+					(odd_bits(data, databits) ^ (par == parity::odd))))
+					? (1U << databits) : 0);
+		}
+
+		static_assert(databits >= 5 && databits <= 9,
+			"Invalid databits value. Valid values are: 5..9");
+		static_assert(bits <= 9, "9 data bits with parity are not supported");
+	};
+
+	/** User work, executed in the bit padding by transmitter::send<work>.
+	  * Work is split in slices, each slice must take exactly cost(i) cycles
+	  * (e.g. be written in inline asm) and must not touch r18..r23.
+	  * Slices are run in order, as many in a padding as fit there, the rest
+	  * of the padding is filled with a delay. This is an empty work		*/
+	struct idle {
+		static constexpr uint8_t slices = 0;
+		static constexpr cycle_t cost(uint8_t) { return 0; }
+		template<uint8_t i>
+		static inline void slice() {}
+	};
 	
 	
+	/** string literal of HAST_STR, each byte is encoded by the driver's
+	 *  prepare() at compile time, so it is sent from flash as is			*/
+	template<typename str>
+	struct flash_string {
+		static constexpr uint8_t size = str::size();
+		/** bytes encoded for the driver, in flash						*/
+		template<typename driver>
+		static inline const uint8_t* data() {
+			return encoded<driver, typename make_indices<size>::type>::bytes;
+		}
+	private:
+		template<typename driver, typename list>
+		struct encoded;
+		template<typename driver, uint8_t ... i>
+		struct encoded<driver, indices<i...>> {
+			static const uint8_t bytes[sizeof...(i)];
+		};
+		static_assert(str::size() > 0 && str::size() < 256,
+			"HAST_STR takes 1 to 255 characters");
+	};
+
+	template<typename str>
+	template<typename driver, uint8_t ... i>
+	const uint8_t flash_string<str>::encoded<driver, indices<i...>>::
+		bytes[sizeof...(i)] HAST_PROGMEM = {
+		driver::prepare(static_cast<uint8_t>(str::text()[i]))...
+	};
+
 	/** transmitter template
 	  * params
 	  *   clock		- system cloc, Hz
@@ -100,40 +273,156 @@ namespace hast {
 	  *				  driver also refers to underlaying MCU for delay 
 	  *				  implementation
 	  *   stopbit	- stop bit duration
+	  *   engine	- time-table engine
+	  *   format	- frame format, hast::frame
 	  *																		*/
 	template<clock_t clock, clock_t baudrate, typename driver,
-		stopbits stopbit = stopbits::one>
+		stopbits stopbit = stopbits::one, timetable engine = timetable::greedy,
+		typename format = frame<>>
 	struct transmitter {
 		using mcu = typename driver::mcu;
+		using line = driver;
+		using frame_t = format;
+		using data_t = typename format::data_t;
 		static constexpr auto cpi = mcu::cpi;
+		/** index of the stop bit in the time-table						*/
+		static constexpr uint8_t stop_slot = format::bits + 1;
 		template<cycle_t period_ic>
 		struct delay : mcu::template delay<period_ic> {};
 		
 		/** send one byte of data											*/		  
 		__attribute__((optimize("-Os")))
-		static volatile void send(uint8_t data) {
-			driver::start(data);
-			delay<t<0>::wait>::cycles();
-			driver::template send<0>(data);
-			delay<t<1>::wait>::cycles();
-			driver::template send<1>(data);
-			delay<t<2>::wait>::cycles();
-			driver::template send<2>(data);
-			delay<t<3>::wait>::cycles();
-			driver::template send<3>(data);
-			delay<t<4>::wait>::cycles();
-			driver::template send<4>(data);
-			delay<t<5>::wait>::cycles();
-			driver::template send<5>(data);
-			delay<t<6>::wait>::cycles();
-			driver::template send<6>(data);
-			delay<t<7>::wait>::cycles();
-			driver::template send<7>(data);
-			delay<t<8>::wait>::cycles();
-			driver::stop(data);
-			delay<t<9>::wait>::cycles();
+		static volatile void send(data_t data) {
+			framing<driver::whole_frame>::send(
+				format::wire(data, ! parity_plan::padded));
 		}
-		
+
+		/** send the rest of a frame after its start edge, bits prepared
+		 *  by format::wire(data, true), see multi_transmitter			*/
+		__attribute__((optimize("-Os")))
+		static void finish(uint16_t bits) {
+			static_assert(! driver::whole_frame,
+				"Driver sends whole frames, use send(data)");
+			parity_plan::prepare(bits);
+			unroll(bits, typename make_indices<format::bits>::type());
+			driver::stop(bits);
+			delay<tail(row<stop_slot>::wait)>::cycles();
+			driver::done();
+		}
+
+		/** send one byte of data, run slices of work in the bit padding
+		 *  NOTE: work::cost must match the actual cycles of each slice	*/
+		template<typename work>
+		__attribute__((optimize("-Os")))
+		static volatile void send(data_t data) {
+			static_assert(fits<work>(), "Work does not fit into the bit padding");
+			static_assert(! driver::whole_frame,
+				"Driver sends whole frames, use send(data)");
+			const uint16_t bits = format::wire(data, ! parity_plan::padded);
+			if( format::bits > 8 && ! parity_plan::padded )
+				driver::extend(((bits ^ (bits << 1)) >> 8) & 1);
+			driver::start(bits);
+			parity_plan::prepare(bits);
+			slots<work, 0>::send(bits);
+			driver::stop(bits);
+			pad<work, stop_slot>();
+			driver::done();
+		}
+
+		/** send one byte of data with a bit loop instead of unrolled
+		 *  slots, takes less ROM at the cost of a larger error, see compact*/
+		__attribute__((optimize("-Os")))
+		static volatile void send_compact(data_t data) {
+			static_assert(compact::feasible,
+				"Baudrate is too high for compact mode, use send");
+			static_assert(! driver::whole_frame,
+				"Driver sends whole frames, use send(data)");
+			static_warn(compact::error <= (milicycles_per_bit / 5),
+				"Bit error exceeds 20% in compact mode, use send");
+			const uint16_t bits = format::wire(data, ! parity_plan::padded);
+			if( format::bits > 8 && ! parity_plan::padded )
+				driver::extend(((bits ^ (bits << 1)) >> 8) & 1);
+			driver::start(bits);
+			parity_plan::prepare(bits);
+			delay<compact::first>::cycles();
+			driver::template loop<format::bits, delay<compact::wait>>();
+			delay<compact::last>::cycles();
+			driver::stop(bits);
+			delay<tail(compact::tail)>::cycles();
+			driver::done();
+		}
+
+		/** send one byte of data, open interrupt windows in the paddings
+		 *  that fit ISRs of budget cycles, see windows. The timer must be
+		 *  running with prescaler 1, e.g. avr::timer0<1>					*/
+		template<typename timer, cycle_t budget>
+		__attribute__((optimize("-Os")))
+		static volatile void send_interruptible(data_t data) {
+			using plan = windows<timer, budget>;
+			static_assert(! driver::whole_frame,
+				"Driver sends whole frames, use send(data)");
+			static_warn(plan::count > 0,
+				"No interrupt window fits, use lower baudrate or ISR budget");
+			const uint16_t bits = format::wire(data, ! parity_plan::padded);
+			if( format::bits > 8 && ! parity_plan::padded )
+				driver::extend(((bits ^ (bits << 1)) >> 8) & 1);
+			driver::start(bits);
+			parity_plan::prepare(bits);
+			const uint8_t origin = driver::template capture<timer>();
+			plan::template slots<0>::send(bits, origin);
+			driver::stop(bits);
+			delay<tail(row<stop_slot>::wait)>::cycles();
+			driver::done();
+		}
+
+		/** true if all slices of work fit into the bit padding			*/
+		template<typename work>
+		static constexpr bool fits() {
+			return fill<work, stop_slot>::to == work::slices;
+		}
+
+		/** send a burst of n bytes. Interrupts are disabled once for
+		 *  the whole buffer, next byte is loaded and prepared in the stop
+		 *  bit padding, so frames follow back-to-back at the line rate
+		 *  NOTE: interrupts are blocked for n frames						*/
+		__attribute__((optimize("-Os")))
+		static volatile void send(const uint8_t* data, uint8_t n) {
+			static_assert(format::plain, "Burst mode requires 8N1 frame format");
+			if( n == 0 ) return;
+			framing<driver::whole_frame>::burst(data, n);
+		}
+
+		/** send a HAST_STR string from flash, see send_P below			*/
+		template<typename str>
+		static inline void send_P(flash_string<str>) {
+			send_P(flash_string<str>::template data<driver>(), str::size());
+		}
+
+		/** send n bytes, encoded by driver::prepare, from flash. Works as
+		 *  burst mode, but the next byte is fetched just before the stop
+		 *  bit padding and the start bit takes no preparation
+		 *  NOTE: interrupts are blocked for n frames						*/
+		__attribute__((optimize("-Os")))
+		static volatile void send_P(const uint8_t* data, uint8_t n) {
+			static_assert(format::plain, "send_P requires 8N1 frame format");
+			static_assert(! driver::whole_frame,
+				"Driver sends whole frames, use send(data, n)");
+			if( n == 0 ) return;
+			driver::begin_P(data);
+			for(;;) { /* no branch between the start edge and slot 0	*/
+				driver::resume();
+				slots<idle, 0>::send(0);
+				driver::hold();
+				if( --n == 0 ) break;
+				driver::fetch_P(data);
+				delay<burst_P::wait>::cycles();
+				driver::restart_P();
+			}
+			driver::release();
+			delay<tail(row<stop_slot>::wait)>::cycles();
+			driver::done();
+		}
+
 		/** initialize the line (call the driver)							*/
 		static inline void init() {
 			driver::init();
@@ -157,6 +446,29 @@ namespace hast {
 		static constexpr cycle_t bitlen(uint8_t bit, cycle_t rstart, time_t mfinish) {
 			return best(mfinish, rstart, timing(bit,rstart, mfinish), timing(bit,rstart, mfinish) + 1);
 		}
+
+		/** ideal bit finish time in mili cycles							*/
+		static constexpr milicycle_t bitfinish(uint8_t bit) {
+			return bit == stop_slot
+				? (milicycles_per_bit*bit +
+				  (milicycles_per_bit*static_cast<milicycle_t>(stopbit))/2)
+				: milicycles_per_bit * (bit+1);
+		}
+
+		/** stop bit padding before driver::done, which takes done_cycles
+		 *  to take effect (e.g. to release RS-485 driver enable)			*/
+		static constexpr cycle_t tail(cycle_t wait) {
+			return wait < driver::done_cycles ? 0 : wait - driver::done_cycles;
+		}
+
+		/** cycles to actuate the edge that ends the bit: the last bit is
+		 *  ended by the stop edge, the stop bit by nothing but padding	*/
+		static constexpr cycle_t bitcycles(uint8_t bit) {
+			return (bit == 0) ? driver::start_cycles + driver::send_cycles
+					+ parity_plan::cycles :
+				bit == format::bits ? driver::stop_cycles :
+				bit == stop_slot ? 0 : driver::send_cycles;
+		}
 			
 		/** recursion terminator 											*/
 		struct t0 {
@@ -167,185 +479,3216 @@ namespace hast {
 		template<uint8_t bit>
 		struct t { /* bit 0 is the start bit 								*/
 			/** cycles to actuate current bit */
-			static constexpr cycle_t cycles = 
-				(bit == 0) ? driver::start_cycles + driver::send_cycles:
-				(bit == 9 ? driver::stop_cycles : driver::send_cycles);
+			static constexpr cycle_t cycles = bitcycles(bit);
 			/** ideal bit start time in mili cycles */
 			static constexpr milicycle_t mstart  = milicycles_per_bit * bit;
 			/** ideal bit finish time in mili cycles */
-			static constexpr milicycle_t mfinish = bit == 9
-					? (milicycles_per_bit*bit +
-					  (milicycles_per_bit*static_cast<milicycle_t>(stopbit))/2)
-					: milicycles_per_bit * (bit+1);
+			static constexpr milicycle_t mfinish = bitfinish(bit);
 
 			/** actual bit start time in cycles - where the previous finishes */
 			static constexpr cycle_t rstart  = prev<bit, t, t0>::rfinish;
 			/** computed bit length in cycles */
-			static constexpr cycle_t length = bitlen(bit, rstart, mfinish);
+			static constexpr cycle_t length =
+				schedule<transmitter, engine>::template length<bit>(rstart, mfinish);
 			/** bit padding period in cycles */
 			static constexpr cycle_t wait = (length < cycles) ? 0 : (length - cycles);
 			/** actual finish time */
 			static constexpr cycle_t rfinish = rstart + wait + cycles;
 			/** absolute error in milicycles 								*/
 			static constexpr milicycle_t error = abs(mfinish - mili * rfinish);
-			static_warn(bit == 9 || error <= (milicycles_per_bit / 5),
+			/** sampling-point (mid-bit) error in milicycles				*/
+			static constexpr milicycle_t serror =
+				abs((mili * rfinish - mfinish) + (mili * rstart - mstart)) / 2;
+			static_warn(bit == stop_slot || error <= (milicycles_per_bit / 5),
 					"Bit error exceeds 20%, use different (lower) baudrate");
-			static_warn(bit == 9 || wait <= driver::mcu::template delay<0>::max,
+			static_warn(bit == stop_slot || wait <= driver::mcu::template delay<0>::max,
 				"Bit error exceeds 20%, use different (lower) baudrate");
+			static_warn(bit == stop_slot || length >= cycles,
+				"Time-table is not feasible, use different engine or baudrate");
 
 			static void debug(); /* implement this method as needed
 													for time-table debugging */
 		};
-	};
-	
-	/************************************************************************/
-	/** AVR-specific concerns												*/
-	struct avr {
-		static constexpr cycle_t cpi = 1; /* clock per instruction			*/
-		using sfr = volatile uint8_t;
-		/** delay loops with 3 (short) and 6 (long) ic per iteration 		*/
-		template<cycle_t period_ic, bool longloop>
-		struct loop;
 
-		/** 
-		 * Register usage:
-		 * r18 - loop count and work register
-		 * r19 - keeps __SREG__ 
-		 * r20 - keeps port state
-		 * r21 - prepared data (data &= (data<<1))
-		 * r22 - toggle mask (1<<bit)
-		 */
+		/** time-table row of the slot. The flat engine takes it from its
+		 *  array, so no t<bit> chain is instantiated						*/
+		template<uint8_t slot, timetable = engine>
+		struct row {
+			static constexpr cycle_t length = t<slot>::length;
+			static constexpr cycle_t wait = t<slot>::wait;
+			static constexpr cycle_t rfinish = t<slot>::rfinish;
+			static constexpr milicycle_t mfinish = t<slot>::mfinish;
+			static constexpr milicycle_t error = t<slot>::error;
+		};
+#if __cplusplus >= 201402L
+		template<uint8_t slot>
+		struct row<slot, timetable::flat> {
+			using plan = schedule<transmitter, engine>;
+			static constexpr cycle_t length = plan::table.length[slot];
+			static constexpr cycle_t wait = plan::table.wait[slot];
+			static constexpr cycle_t rfinish = plan::table.rfinish[slot];
+			static constexpr milicycle_t mfinish = bitfinish(slot);
+			static constexpr milicycle_t error = plan::table.error[slot];
+		};
+#endif
 
-		/** delay injector 													*/
-		template<cycle_t period_ic>	
-		struct delay {
-			static constexpr cycle_t max = 255*6 + 2;
-			__attribute__((always_inline)) 
-			static inline volatile void cycles() {
-				loop<period_ic, longloop>::cycles();
-			}
-			static_warn(period_ic <= max, "Delay too long");
-		private:
-			static constexpr bool longloop = period_ic > (255*3);
+		/* first slot from the given one with room for the fetch of the
+		 * next byte of a burst, stop_slot if no bit padding has it		*/
+		template<uint8_t slot = 0, bool last = (slot > format::bits)>
+		struct fetch_at {
+			static constexpr uint8_t value = row<slot>::wait >= driver::fetch_cycles
+				? slot : fetch_at<slot + 1>::value;
+		};
+		template<uint8_t slot>
+		struct fetch_at<slot, true> {
+			static constexpr uint8_t value = stop_slot;
 		};
 
-		/** PORT driver - uses out to drive the pin							*/
-		template<uint8_t port, uint8_t ddr, uint8_t pin, uint8_t space = uart_space_level>
-		struct driver {
-			/* NOTE: driver disables interrupts on start and enables on stop
-					 driver uses the following sequence to send a bit:
-						sbrc (data), (bit)
-						eor  r20, (1<<bit)
-						out  (port), r20									*/
-			using mcu = avr;  /* hast::trasmitter uses mcu::delay			*/
-			static constexpr cycle_t send_cycles  = 3; /* sbrc, eor, out	*/
-			static constexpr cycle_t start_cycles = 0; /* nothing after out */
-			static constexpr cycle_t stop_cycles  = 2; /* ori, out			*/
+		/** stop bit padding in burst mode: stop bit length less the loop
+		 *  branch and the restart. The next byte is loaded and prepared
+		 *  in the first bit padding with room for it, in the stop bit only
+		 *  if there is none, then straight into place. The start edge is
+		 *  at the top of the loop, so the branch precedes it. If negative,
+		 *  the stop bit gets longer by -gap cycles						*/
+		struct burst {
+			/** slot whose padding fetches the next byte					*/
+			static constexpr uint8_t fetch = fetch_at<>::value;
+			static constexpr cycle_t gap = row<stop_slot>::length - mcu::branch_cycles
+				- driver::restart_cycles - (fetch == stop_slot
+				? driver::fetch_cycles - driver::take_cycles : 0);
+			static constexpr cycle_t wait = gap < 0 ? 0 : gap;
+		};
 
-			/** initialize port for output									*/
-			__attribute__((always_inline)) 
-			static inline void init() {
-				if( space == 0 )
-					asm volatile ("sbi %0,%2\n sbi %1, %2" 
-								 :: "I" (port), "I" (ddr), "I" (pin): "memory");
-				else
-					asm volatile ("cbi %0,%2\n sbi %1, %2" 
-								 :: "I" (port), "I" (ddr), "I" (pin): "memory");
+		/** stop bit padding of send_P: the next byte is fetched from flash
+		 *  before the padding, only the start edge is after it			*/
+		struct burst_P {
+			static constexpr cycle_t gap = row<stop_slot>::length - mcu::branch_cycles
+				- driver::fetch_P_cycles - driver::restart_P_cycles;
+			static constexpr cycle_t wait = gap < 0 ? 0 : gap;
+		};
+
+		/** program memory of paddings and bit sequences of send, words	*/
+		static constexpr cycle_t words() {
+			return unrolled_words<0>::value;
+		}
+
+	private:
+		template<uint8_t bit, bool last = (bit > format::bits)>
+		struct unrolled_words {
+			static constexpr cycle_t value = mcu::delay_words(row<bit>::wait)
+				+ (bit < format::bits ? driver::send_cycles : 0)
+				+ unrolled_words<bit + 1>::value;
+		};
+		template<uint8_t bit>
+		struct unrolled_words<bit, true> {
+			static constexpr cycle_t value = 0;
+		};
+
+		/* index of the first slice past those fitting into budget		*/
+		template<typename work>
+		static constexpr uint8_t reach(uint8_t i, cycle_t budget) {
+			return i < work::slices && work::cost(i) <= budget
+				? reach<work>(i + 1, budget - work::cost(i)) : i;
+		}
+		/* cycles taken by slices from i to last, exclusive				*/
+		template<typename work>
+		static constexpr cycle_t spent(uint8_t i, uint8_t last) {
+			return i < last ? work::cost(i) + spent<work>(i + 1, last) : 0;
+		}
+
+		/** slices of work placed in the padding of the slot				*/
+		template<typename work, uint8_t slot>
+		struct fill {
+			static constexpr uint8_t from = fill<work, slot - 1>::to;
+			static constexpr uint8_t to = reach<work>(from, row<slot>::wait);
+			static constexpr cycle_t used = spent<work>(from, to);
+		};
+		template<typename work>
+		struct fill<work, 0> {
+			static constexpr uint8_t from = 0;
+			static constexpr uint8_t to = reach<work>(from, row<0>::wait);
+			static constexpr cycle_t used = spent<work>(from, to);
+		};
+
+		/** run slices from i to last, exclusive							*/
+		template<typename work, uint8_t i, uint8_t last, bool done = (i >= last)>
+		struct perform {
+			__attribute__((always_inline))
+			static inline void run() {
+				work::template slice<i>();
+				perform<work, i + 1, last>::run();
 			}
+		};
+		template<typename work, uint8_t i, uint8_t last>
+		struct perform<work, i, last, true> {
+			__attribute__((always_inline))
+			static inline void run() {}
+		};
 
-			/** prepare data, disable interrupts, send start bit 			*/
-			__attribute__((always_inline)) 
-			static inline void start(uint8_t data) {
-				asm volatile ("mov r18, %0\n mov r21, r18" 
-							 :"=r"(data) :: "cc", "r18", "r21", "memory");
-				asm volatile ("lsl r18\n eor r21, r18\n ldi r22,%0" 
-							 ::"M"(1<<pin): "cc", "r18", "r21", "r22", "memory");
-				if( space == 0 )
-					asm volatile ("in r20, %0\n andi r20,~%1\n in r19, __SREG__\n cli\n out %0, r20"
-								 ::"I" (port), "M"(1<<pin) : "cc", "r20", "r19", "memory");
-				else
-					asm volatile ("in r20, %0\n ori  r20,%1\n in r19, __SREG__\n cli\n out %0, r20"
-								 ::"I" (port), "M"(1<<pin) : "cc", "r20", "r19", "memory");
+		/** padding of the slot: work slices and the remaining delay		*/
+		template<typename work, uint8_t slot>
+		__attribute__((always_inline))
+		static inline void pad() {
+			perform<work, fill<work, slot>::from, fill<work, slot>::to>::run();
+			delay<row<slot>::wait - fill<work, slot>::used>::cycles();
+		}
+
+		/** frame and burst sequences of drivers sending bit by bit		*/
+		template<bool whole, int = 0>
+		struct framing {
+			__attribute__((always_inline))
+			static inline void send(uint16_t bits) {
+				if( format::bits > 8 && ! parity_plan::padded )
+					driver::extend(((bits ^ (bits << 1)) >> 8) & 1);
+				driver::start(bits);
+				parity_plan::prepare(bits);
+				unroll(bits, typename make_indices<format::bits>::type());
+				driver::stop(bits);
+				delay<tail(row<stop_slot>::wait)>::cycles();
+				driver::done();
 			}
-			/** send a bit 															*/
-			template<uint8_t bit>
+			__attribute__((always_inline))
+			static inline void burst(const uint8_t* data, uint8_t n) {
+				constexpr bool late = transmitter::burst::fetch == stop_slot;
+				driver::begin(*data++);
+				for(;;) { /* no branch between the start edge and slot 0	*/
+					driver::resume();
+					burst_slots<0>::send(data);
+					driver::hold();
+					if( --n == 0 ) break;
+					if( late )
+						driver::template fetch<late>(data);
+					delay<transmitter::burst::wait>::cycles();
+					driver::template restart<late>();
+				}
+				driver::release();
+				delay<tail(row<stop_slot>::wait)>::cycles();
+				driver::done();
+			}
+		};
+		/** drivers sending a whole frame or burst in one sequence take
+		 *  the paddings as a layout										*/
+		template<int dummy>
+		struct framing<true, dummy> {
+			__attribute__((always_inline))
+			static inline void send(uint16_t bits) {
+				driver::template frame<layout>(bits);
+				delay<tail(row<stop_slot>::wait)>::cycles();
+				driver::done();
+			}
+			__attribute__((always_inline))
+			static inline void burst(const uint8_t* data, uint8_t n) {
+				driver::template burst<layout>(data, n);
+				delay<tail(row<stop_slot>::wait)>::cycles();
+				driver::done();
+			}
+		};
+
+		/** bit slots of send, padding and bit for each data bit, then the
+		 *  padding of the last one. Expanded from the index list, so the
+		 *  frame length takes no recursion								*/
+		template<uint8_t ... bit>
+		__attribute__((always_inline))
+		static inline void unroll(uint16_t bits, indices<bit...>) {
+			using expand = int[];
+			(void) expand { 0, (delay<row<bit>::wait>::cycles(),
+				driver::template send<bit>(bits), 0)... };
+			delay<row<format::bits>::wait>::cycles();
+		}
+
+		/** unrolled bit slots from bit to the stop bit, exclusive		*/
+		template<typename work, uint8_t bit, bool last = (bit == format::bits)>
+		struct slots {
 			__attribute__((always_inline))
 			static inline void send(uint8_t data) {
-				asm volatile ("sbrc r21, %0\n eor r20, r22\n out %1, r20" 
-							 :: "I" (bit), "I" (port): "r21", "r22", "memory");
+				pad<work, bit>();
+				driver::template send<bit>(data);
+				slots<work, bit+1>::send(data);
 			}
-			/** send stop bit, enable interrupts				 					*/
+		};
+		template<typename work, uint8_t bit>
+		struct slots<work, bit, true> {
 			__attribute__((always_inline))
-			static inline volatile void stop(uint8_t data) {
-				if( space == 0 )
-					asm volatile ("ori r20,%1\n out %0, r20\n out __SREG__, r19"
-								 ::"I" (port), "M"(1<<pin):"cc", "r20", "r19", "memory");
-				else
-					asm volatile ("andi r20,~%1\n out %0, r20\n out __SREG__, r19"
-								 ::"I" (port), "M"(1<<pin):"cc", "r20", "r19", "memory");
+			static inline void send(uint8_t) {
+				pad<work, bit>();
 			}
-		private:
-			static_assert(space==0 || space==1, "Invalid space value. Valid values are: 0, 1");
 		};
-		
-		/** shortcut for hast::transmitter with avr::driver							*/
-		template<clock_t clock, clock_t baudrate, uint8_t port, uint8_t pin, 
-				 uint8_t space = uart_space_level, stopbits sb=stopbits::one>
-		struct transmitter;
-	};
 
-	/* Implementation of delay injectors
-	   credits to http://www.bretmulvey.com/avrdelay.html							*/
-	template<> inline volatile void avr::delay< 0>::cycles() {}
-	template<> inline volatile void avr::delay< 1>::cycles() { asm volatile("nop"); }
-	template<> inline volatile void avr::delay< 2>::cycles() { asm volatile("rjmp ."); }
-	template<> inline volatile void avr::delay< 3>::cycles() { asm volatile("lpm"); }
-	template<> inline volatile void avr::delay< 4>::cycles() { delay<2>::cycles(); delay<2>::cycles(); }
-	template<> inline volatile void avr::delay< 5>::cycles() { delay<3>::cycles(); delay<2>::cycles(); }
-	template<> inline volatile void avr::delay< 6>::cycles() { delay<3>::cycles(); delay<3>::cycles(); }
-	template<> inline volatile void avr::delay< 7>::cycles() { delay<6>::cycles(); delay<1>::cycles(); }
-	template<> inline volatile void avr::delay< 8>::cycles() { delay<6>::cycles(); delay<2>::cycles(); }
-	template<> inline volatile void avr::delay< 9>::cycles() { delay<6>::cycles(); delay<3>::cycles(); }
-	template<> inline volatile void avr::delay<10>::cycles() { delay<9>::cycles(); delay<1>::cycles(); }
-	template<> inline volatile void avr::delay<11>::cycles() { delay<9>::cycles(); delay<2>::cycles(); }
-		
-	/** Short loop delay (period/3 cycles)											*/
-	template<cycle_t period_ic>
-	struct avr::loop<period_ic, false> {
-		static constexpr cycle_t count = period_ic/3;
-		static_warn(count <= 255, "Loop is too long");
-		__attribute__((always_inline)) 
-		static inline volatile void cycles() {
-			asm volatile ("ldi  r18, %0\n dec  r18\n brne .-4"
-						::"M"(count):"cc","r18");
-			delay<period_ic % 3>::cycles();			
+		/** padding of a burst slot, the fetch slot loads and prepares
+		 *  the next byte. The last frame reads the byte after the buffer
+		 *  and ignores it, there is no branch in the frame				*/
+		template<uint8_t slot>
+		__attribute__((always_inline))
+		static inline void burst_pad(const uint8_t*& data) {
+			constexpr bool here = slot == burst::fetch;
+			if( here )
+				driver::fetch(data);
+			delay<here ? row<slot>::wait - driver::fetch_cycles
+				: row<slot>::wait>::cycles();
 		}
-	};
-	
-	/** Long loop delay (period/6 cycles)											*/
-	template<cycle_t period_ic>
-	struct avr::loop<period_ic, true> {
-		static constexpr cycle_t count = period_ic/6;
-		static_warn(count <= 255, "Loop is too long");
-		__attribute__((always_inline)) 
-		static inline volatile void cycles() {
-			asm volatile ("ldi  r18, %0\n lpm; \n dec  r18\n brne .-5"
-						::"M" (count):"cc","r18");
-			delay<period_ic % 6>::cycles();			
+		/** unrolled bit slots of a burst frame, from bit to the stop bit	*/
+		template<uint8_t bit, bool last = (bit == format::bits)>
+		struct burst_slots {
+			__attribute__((always_inline))
+			static inline void send(const uint8_t*& data) {
+				burst_pad<bit>(data);
+				driver::template send<bit>(0);
+				burst_slots<bit + 1>::send(data);
+			}
+		};
+		template<uint8_t bit>
+		struct burst_slots<bit, true> {
+			__attribute__((always_inline))
+			static inline void send(const uint8_t*& data) {
+				burst_pad<bit>(data);
+			}
+		};
+
+		/** parity is computed in the start bit padding when it fits there,
+		 *  otherwise before the start bit, with interrupts enabled		*/
+		template<bool computed, int = 0>
+		struct parity_calc {
+			static constexpr bool padded = false;
+			static constexpr cycle_t cycles = 0;
+			__attribute__((always_inline))
+			static inline void prepare(uint8_t) {}
+		};
+		template<int dummy>
+		struct parity_calc<true, dummy> {
+			static constexpr cycle_t need = driver::template
+				parity_cycles<format::data_bits, format::parity_mode == parity::odd>();
+			static constexpr bool padded = milicycles_per_bit / mili
+				>= need + driver::start_cycles + driver::send_cycles + 1;
+			static constexpr cycle_t cycles = padded ? need : 0;
+			__attribute__((always_inline))
+			static inline void prepare(uint8_t bits) {
+				if( padded )
+					driver::template parity<format::data_bits,
+						format::parity_mode == parity::odd>(bits);
+			}
+		};
+		using parity_plan = parity_calc<format::computed>;
+
+		/* padding of a data slot, 0 past the last one					*/
+		template<uint8_t slot, bool data = (slot < format::bits)>
+		struct slot_wait {
+			static constexpr cycle_t value = row<slot>::wait;
+		};
+		template<uint8_t slot>
+		struct slot_wait<slot, false> {
+			static constexpr cycle_t value = 0;
+		};
+
+		/** paddings of a whole frame, wN precedes the edge of data bit N	*/
+		struct layout {
+			static constexpr uint8_t bits = format::bits;
+			/** data bits covered by parity computed in the start slot,
+			 *  0 if parity is computed before the frame or not at all	*/
+			static constexpr uint8_t parity =
+				parity_plan::padded ? format::data_bits : 0;
+			static constexpr bool odd = format::parity_mode == hast::parity::odd;
+			static constexpr cycle_t w0 = slot_wait<0>::value;
+			static constexpr cycle_t w1 = slot_wait<1>::value;
+			static constexpr cycle_t w2 = slot_wait<2>::value;
+			static constexpr cycle_t w3 = slot_wait<3>::value;
+			static constexpr cycle_t w4 = slot_wait<4>::value;
+			static constexpr cycle_t w5 = slot_wait<5>::value;
+			static constexpr cycle_t w6 = slot_wait<6>::value;
+			static constexpr cycle_t w7 = slot_wait<7>::value;
+			/** padding before the stop edge								*/
+			static constexpr cycle_t stop = row<format::bits>::wait;
+			/** stop bit padding between frames of a burst				*/
+			static constexpr cycle_t gap = burst::wait;
+		};
+
+		/* cycles from the start edge to the first data edge in compact
+		 * mode, minimum													*/
+		static constexpr cycle_t compact_lead = driver::start_cycles
+			+ parity_plan::cycles + driver::loop_setup_cycles + driver::send_cycles;
+		/* first data edge for the bit length in compact mode				*/
+		static constexpr cycle_t compact_edge(cycle_t len) {
+			return (2 * milicycles_per_bit - (format::bits - 1)
+					* (len * mili - milicycles_per_bit) + mili) / (2 * mili)
+				< compact_lead ? compact_lead
+				: (2 * milicycles_per_bit - (format::bits - 1)
+					* (len * mili - milicycles_per_bit) + mili) / (2 * mili);
 		}
-	};
+		/* worst data edge error for the bit length in compact mode		*/
+		static constexpr milicycle_t compact_spread(cycle_t len) {
+			return abs(compact_edge(len) * mili - milicycles_per_bit) >
+				abs((compact_edge(len) + (format::bits - 1) * len) * mili
+					- format::bits * milicycles_per_bit)
+				? abs(compact_edge(len) * mili - milicycles_per_bit)
+				: abs((compact_edge(len) + (format::bits - 1) * len) * mili
+					- format::bits * milicycles_per_bit);
+		}
+	public:
 
-/* Use of PORTx is not allowed in templates, ADDR_OF provides a workaround		*/
-#ifdef _SFR_IO8
-#define ADDR_OF(R) ((&R)-&_SFR_IO8(0))
+		/** compact mode time-table: data edges are spaced uniformly by
+		 *  length, the first one is shifted to center the error			*/
+		struct compact {
+			/** shortest bit length the loop can do							*/
+			static constexpr cycle_t shortest = driver::send_cycles + driver::loop_cycles;
+			static constexpr cycle_t floor = milicycles_per_bit / mili;
+			/** uniform bit length											*/
+			static constexpr cycle_t length = compact_spread(floor + 1)
+				< compact_spread(floor) || floor < shortest ? floor + 1 : floor;
+			static constexpr bool feasible = length >= shortest;
+			/** padding in the loop											*/
+			static constexpr cycle_t wait = feasible ? length - shortest : 0;
+			/** padding before the loop										*/
+			static constexpr cycle_t first = compact_edge(length) - compact_lead;
+			/** last data edge												*/
+			static constexpr cycle_t final = compact_edge(length)
+				+ (format::bits - 1) * length;
+			/* earliest stop edge the loop allows						*/
+			static constexpr cycle_t earliest = final + wait
+				+ (driver::loop_cycles - 1) + driver::stop_cycles;
+			/* ideal stop edge											*/
+			static constexpr cycle_t ideal =
+				((format::bits + 1) * milicycles_per_bit + mili / 2) / mili;
+			/** stop edge, nearest feasible									*/
+			static constexpr cycle_t stop = earliest > ideal ? earliest : ideal;
+			/** padding between the loop and the stop edge					*/
+			static constexpr cycle_t last = stop - earliest;
+			/** padding after the stop edge									*/
+			static constexpr cycle_t tail =
+				(bitfinish(stop_slot) + mili / 2) / mili > stop
+				? (bitfinish(stop_slot) + mili / 2) / mili - stop : 0;
+			/** worst edge error, milicycles									*/
+			static constexpr milicycle_t error = compact_spread(length) >
+				abs(stop * mili - (format::bits + 1) * milicycles_per_bit)
+				? compact_spread(length)
+				: abs(stop * mili - (format::bits + 1) * milicycles_per_bit);
+			/** program memory of paddings and bit sequences, words			*/
+			static constexpr cycle_t words = mcu::delay_words(first)
+				+ driver::loop_setup_cycles + driver::send_cycles
+				+ mcu::delay_words(wait) + driver::loop_cycles - 1
+				+ mcu::delay_words(last);
+		};
 
-#if defined(PORTA0) || defined(PORTA1) || defined(PORTA2) || defined(PORTA3) || \
-	defined(PORTA4) || defined(PORTA5) || defined(PORTA6) || defined(PORTA7)
-	template<clock_t clock, clock_t baudrate, uint8_t pin, uint8_t space, stopbits sb>
-	struct avr::transmitter<clock, baudrate, ADDR_OF(PORTA), pin, space, sb> :
-		hast::transmitter<clock, baudrate, driver<ADDR_OF(PORTA), 
-		ADDR_OF(DDRA), pin, space>, sb> {};
-#endif
+		/** interrupt windows for ISRs taking up to budget cycles in total,
+		 *  including entry and reti. A window takes the end of a padding:
+		 *  SREG is restored for two cycles, pending interrupts run, then
+		 *  the timer is polled up to the planned edge and the port image
+		 *  is read back. Without interrupts the edge is exact, otherwise
+		 *  it is late by poll_cycles-1 at most							*/
+		template<typename timer, cycle_t budget>
+		struct windows {
+			/** padding taken by a window, cycles							*/
+			static constexpr cycle_t span = timer::window_cycles
+				+ (budget + timer::poll_cycles - 1)
+				/ timer::poll_cycles * timer::poll_cycles
+				+ driver::reload_cycles;
+			/** cycles from the start edge to the timer capture			*/
+			static constexpr cycle_t lead = driver::start_cycles + parity_plan::cycles;
+
+			/** window in the padding of the slot, slots 0..format::bits	*/
+			template<uint8_t slot, bool first = (slot == 0)>
+			struct gap {
+				using before = gap<slot - 1>;
+				/** padding available for the window						*/
+				static constexpr cycle_t room = row<slot>::wait;
+				/** end of the padding, cycles from the timer capture	*/
+				static constexpr cycle_t end = before::end + driver::send_cycles + room;
+				static constexpr bool open = room >= span;
+				/** opening of the window, cycles from the start edge		*/
+				static constexpr cycle_t at = lead + end - span;
+				/** timer count of the exiting poll, from the capture	*/
+				static constexpr uint8_t target = (end - driver::reload_cycles
+					- timer::poll_cycles + 1) & 0xFF;
+				static constexpr uint8_t count = before::count + (open ? 1 : 0);
+				/** last opening so far, cycles from the start edge		*/
+				static constexpr cycle_t last = open ? at : before::last;
+				/** longest interval without a window so far, cycles		*/
+				static constexpr cycle_t latency = open && at - before::last
+					> before::latency ? at - before::last : before::latency;
+				static_warn(! open || row<slot>::error + mili * (timer::poll_cycles - 1)
+					<= milicycles_per_bit / 5,
+					"Window jitter makes bit error exceed 20%, use lower baudrate");
+			};
+			template<uint8_t slot>
+			struct gap<slot, true> {
+				/* the capture takes the beginning of the start bit padding*/
+				static constexpr cycle_t room = row<0>::wait - timer::read_cycles;
+				static constexpr cycle_t end = row<0>::wait;
+				static constexpr bool open = room >= span;
+				static constexpr cycle_t at = lead + end - span;
+				static constexpr uint8_t target = (end - driver::reload_cycles
+					- timer::poll_cycles + 1) & 0xFF;
+				static constexpr uint8_t count = open ? 1 : 0;
+				static constexpr cycle_t last = open ? at : 0;
+				static constexpr cycle_t latency = last;
+				static_warn(! open || row<0>::error + mili * (timer::poll_cycles - 1)
+					<= milicycles_per_bit / 5,
+					"Window jitter makes bit error exceed 20%, use lower baudrate");
+			};
+
+			/** number of windows in a frame								*/
+			static constexpr uint8_t count = gap<format::bits>::count;
+			/** interrupts are enabled by stop, cycles from the start edge	*/
+			static constexpr cycle_t release = lead + gap<format::bits>::end
+				+ driver::stop_cycles;
+			/** worst case interrupt latency added by a frame, cycles		*/
+			static constexpr cycle_t latency =
+				release - gap<format::bits>::last > gap<format::bits>::latency
+				? release - gap<format::bits>::last : gap<format::bits>::latency;
+
+			/** padding of the slot: delay, then the window if it fits		*/
+			template<uint8_t slot>
+			__attribute__((always_inline))
+			static inline void pad(uint8_t origin) {
+				using g = gap<slot>;
+				delay<g::open ? g::room - span : g::room>::cycles();
+				if( g::open )
+					driver::template window<timer, g::target>(origin);
+			}
+
+			/** unrolled bit slots with windows, origin is the captured
+			 *  timer count													*/
+			template<uint8_t bit, bool last = (bit == format::bits)>
+			struct slots {
+				__attribute__((always_inline))
+				static inline void send(uint8_t data, uint8_t origin) {
+					pad<bit>(origin);
+					driver::template send<bit>(data);
+					slots<bit + 1>::send(data, origin);
+				}
+			};
+			template<uint8_t bit>
+			struct slots<bit, true> {
+				__attribute__((always_inline))
+				static inline void send(uint8_t, uint8_t origin) {
+					pad<bit>(origin);
+				}
+			};
+
+			static_assert(timer::prescaler == 1,
+				"Interrupt windows require timer prescaler 1");
+			static_assert(span < 128,
+				"ISR budget is too large for interrupt windows");
+		};
+	};
+
+	/** greedy engine - nearest cycle for each bit, bit 0 forward			*/
+	template<typename tx>
+	struct schedule<tx, timetable::greedy> {
+		template<uint8_t bit>
+		static constexpr cycle_t length(cycle_t rstart, milicycle_t mfinish) {
+			return tx::bitlen(bit, rstart, mfinish);
+		}
+	};
+
+#if __cplusplus >= 201402L
+	/** flat engine - greedy time-table, computed by one constexpr
+	 *  function into an array. transmitter::row takes the slots from the
+	 *  array, so no send path instantiates the t<bit> chain			*/
+	template<typename tx>
+	struct schedule<tx, timetable::flat> : schedule<tx, timetable::greedy> {
+		struct slots {
+			cycle_t length[tx::stop_slot + 1];
+			cycle_t wait[tx::stop_slot + 1];
+			cycle_t rfinish[tx::stop_slot + 1];
+			milicycle_t error[tx::stop_slot + 1];
+		};
+		static constexpr slots build() {
+			slots res {};
+			cycle_t rfinish = 0;
+			for(uint8_t bit = 0; bit <= tx::stop_slot; ++bit) {
+				const cycle_t rstart = rfinish;
+				const cycle_t cycles = tx::bitcycles(bit);
+				res.length[bit] = tx::bitlen(bit, rstart, tx::bitfinish(bit));
+				res.wait[bit] = res.length[bit] < cycles ? 0 : res.length[bit] - cycles;
+				rfinish = rstart + res.wait[bit] + cycles;
+				res.rfinish[bit] = rfinish;
+				res.error[bit] = abs(tx::bitfinish(bit) - mili * rfinish);
+			}
+			return res;
+		}
+		static constexpr slots table = build();
+
+		/** true if all data bits pass the checks t<bit> makes			*/
+		static constexpr bool feasible() {
+			for(uint8_t bit = 0; bit < tx::stop_slot; ++bit)
+				if( table.error[bit] > tx::milicycles_per_bit / 5 ||
+					table.wait[bit] > tx::mcu::template delay<0>::max ||
+					table.length[bit] < tx::bitcycles(bit) )
+					return false;
+			return true;
+		}
+		static_warn(feasible(),
+			"Bit error exceeds 20% or time-table is not feasible, use different baudrate");
+	};
+#else
+	/** flat engine needs C++14 constexpr loops, the greedy base only
+	 *  keeps the error down to the message below						*/
+	template<typename tx>
+	struct schedule<tx, timetable::flat> : schedule<tx, timetable::greedy> {
+		static_assert(sizeof(tx*) == 0,
+			"Flat time-table engine requires C++14, use timetable::greedy");
+	};
+#endif
+
+	/** minimax engine - each edge is either floor or ceil of its ideal
+	 *  time, choice is made by dynamic programming over the frame so that
+	 *  the maximum mid-bit error is minimal								*/
+	template<typename tx>
+	struct schedule<tx, timetable::minimax> {
+		static constexpr milicycle_t none = 0x7FFFFFFFFFFFLL;
+		static constexpr cycle_t max_wait = tx::mcu::template delay<0>::max;
+
+		static constexpr milicycle_t max(milicycle_t a, milicycle_t b) {
+			return a < b ? b : a;
+		}
+		static constexpr bool fits(uint8_t bit, cycle_t from, cycle_t to) {
+			return to - from >= tx::bitcycles(bit)
+				&& to - from - tx::bitcycles(bit) <= max_wait;
+		}
+
+		/** start edge - the only candidate, no error					*/
+		struct origin {
+			static constexpr cycle_t at(uint8_t) { return 0; }
+			static constexpr milicycle_t err(uint8_t) { return 0; }
+			static constexpr milicycle_t cost(uint8_t c) { return c == 0 ? 0 : none; }
+		};
+
+		/** candidates for the edge finishing the bit, with the minimal
+		 *  worst mid-bit error of the frame up to this bit				*/
+		template<uint8_t bit>
+		struct level {
+			using p = prev<bit, level, origin>;
+			static constexpr milicycle_t ideal = tx::bitfinish(bit);
+			static constexpr cycle_t at(uint8_t c) { return ideal / mili + c; }
+			static constexpr milicycle_t err(uint8_t c) { return mili * at(c) - ideal; }
+			/** worst error when coming from candidate pc				*/
+			static constexpr milicycle_t through(uint8_t c, uint8_t pc) {
+				return p::cost(pc) == none || ! fits(bit, p::at(pc), at(c)) ? none
+					: max(p::cost(pc), abs(p::err(pc) + err(c)) / 2);
+			}
+			/** best predecessor for candidate c							*/
+			static constexpr uint8_t from(uint8_t c) {
+				return through(c, 0) <= through(c, 1) ? 0 : 1;
+			}
+			/* kept as data members to evaluate each level only once		*/
+			static constexpr milicycle_t cost0 = through(0, from(0));
+			static constexpr milicycle_t cost1 = through(1, from(1));
+			static constexpr milicycle_t cost(uint8_t c) {
+				return c == 0 ? cost0 : cost1;
+			}
+		};
+
+		/** back-tracking from the end of stop bit						*/
+		template<uint8_t bit, bool last = (bit >= tx::stop_slot)>
+		struct pick {
+			static constexpr uint8_t c = level<bit+1>::from(pick<bit+1>::c);
+		};
+		template<uint8_t bit>
+		struct pick<bit, true> {
+			static constexpr uint8_t c =
+				level<bit>::cost(0) < level<bit>::cost(1) ? 0 :
+				level<bit>::cost(1) < level<bit>::cost(0) ? 1 :
+				(abs(level<bit>::err(0)) <= abs(level<bit>::err(1)) ? 0 : 1);
+		};
+
+		/** true if a time-table exists within driver and delay limits	*/
+		static constexpr bool feasible =
+			level<tx::stop_slot>::cost(pick<tx::stop_slot>::c) != none;
+		static_warn(feasible, "No feasible minimax time-table, use greedy engine");
+
+		template<uint8_t bit>
+		static constexpr cycle_t length(cycle_t rstart, milicycle_t) {
+			return level<bit>::at(pick<bit>::c) - rstart;
+		}
+	};
+
+	/** receiver template
+	  * params
+	  *   clock		- system cloc, Hz
+	  *   baudrate	- UART baudrate, baud
+	  *   driver	- class, implementing hardware specific line sampling
+	  *				  driver also refers to underlaying MCU for delay
+	  *				  implementation
+	  *																		*/
+	template<clock_t clock, clock_t baudrate, typename driver>
+	struct receiver {
+		using mcu = typename driver::mcu;
+		static constexpr auto cpi = mcu::cpi;
+		template<cycle_t period_ic>
+		struct delay : mcu::template delay<period_ic> {};
+
+		/** wait for the start bit and receive one byte of data
+		 *  returns false on framing error (stop bit is not MARK) and on a
+		 *  glitch (line is back to MARK in the middle of the start bit)
+		 *  NOTE: interrupts are disabled while waiting for the start bit	*/
+		__attribute__((optimize("-Os")))
+		static volatile bool receive(uint8_t& data) {
+			const uint8_t sreg = driver::start(data);
+			delay<rs::wait>::cycles();
+			if( ! driver::confirm() )
+				return driver::reject(sreg);
+			delay<r<0>::wait>::cycles();
+			driver::template sample<0>(data);
+			delay<r<1>::wait>::cycles();
+			driver::template sample<1>(data);
+			delay<r<2>::wait>::cycles();
+			driver::template sample<2>(data);
+			delay<r<3>::wait>::cycles();
+			driver::template sample<3>(data);
+			delay<r<4>::wait>::cycles();
+			driver::template sample<4>(data);
+			delay<r<5>::wait>::cycles();
+			driver::template sample<5>(data);
+			delay<r<6>::wait>::cycles();
+			driver::template sample<6>(data);
+			delay<r<7>::wait>::cycles();
+			driver::template sample<7>(data);
+			delay<r<8>::wait>::cycles();
+			return driver::stop(sreg);
+		}
+
+		/** initialize the line (call the driver)							*/
+		static inline void init() {
+			driver::init();
+		}
+
+		static constexpr milicycle_t milicycles_per_bit =
+				(mili * clock / cpi) / baudrate;
+		static_warn(milicycles_per_bit >= mili * driver::sample_cycles,
+				"Baudrate is too high for given clock and driver");
+		static_warn(milicycles_per_bit <= mili * delay<milicycles_per_bit/mili>::max,
+				"Baudrate is too low for given clock and driver");
+
+		static constexpr cycle_t nearest(milicycle_t goal) {
+			return goal < 0 ? 0 : (goal + mili/2) / mili;
+		}
+
+		/** recursion terminator, time 0 is when the start bit is detected	*/
+		struct r0 {
+			static constexpr cycle_t rfinish = driver::start_cycles;
+		};
+
+		/** start bit re-check at its mid-point, a shorter pulse is a glitch*/
+		struct rs {
+			static constexpr milicycle_t mpoint =
+				milicycles_per_bit/2 - driver::detect_latency;
+			static constexpr cycle_t rstart  = r0::rfinish;
+			static constexpr cycle_t wait =
+				nearest(mpoint - mili*(rstart + driver::confirm_lead));
+			static constexpr cycle_t rpoint = rstart + wait + driver::confirm_lead;
+			static constexpr cycle_t rfinish = rstart + wait + driver::confirm_cycles;
+		};
+
+		/** sampling time-table												*/
+		template<uint8_t bit>
+		struct r { /* bit 8 is the stop bit									*/
+			/** cycles from the sequence start to the sampling instant */
+			static constexpr cycle_t lead =
+				bit == 8 ? driver::stop_lead : driver::sample_lead;
+			/** cycles to sample current bit */
+			static constexpr cycle_t cycles =
+				bit == 8 ? driver::stop_cycles : driver::sample_cycles;
+			/** ideal sampling time (mid-bit) in mili cycles */
+			static constexpr milicycle_t mpoint = milicycles_per_bit * (bit+1)
+				+ milicycles_per_bit/2 - driver::detect_latency;
+			/** actual sequence start time in cycles */
+			static constexpr cycle_t rstart  = prev<bit, r, rs>::rfinish;
+			/** bit padding period in cycles */
+			static constexpr cycle_t wait = nearest(mpoint - mili*(rstart + lead));
+			/** actual sampling time in cycles */
+			static constexpr cycle_t rpoint = rstart + wait + lead;
+			/** actual finish time */
+			static constexpr cycle_t rfinish = rstart + wait + cycles;
+			/** absolute error in milicycles, including detection jitter	*/
+			static constexpr milicycle_t error =
+				abs(mpoint - mili * rpoint) + driver::detect_latency;
+			static_warn(error <= (milicycles_per_bit * 3) / 10,
+					"Sampling error exceeds 30%, use different (lower) baudrate");
+			static_warn(wait <= driver::mcu::template delay<0>::max,
+					"Sampling error exceeds 30%, use different (lower) baudrate");
+
+			static void debug(); /* implement this method as needed
+													for time-table debugging */
+		};
+	};
+
+	/** parallel transmitter template, sends one byte per channel on all
+	 *  driver channels simultaneously, using the transmitter's time-table
+	  * params
+	  *   clock		- system cloc, Hz
+	  *   baudrate	- UART baudrate, baud
+	  *   driver	- class, implementing multi-channel line control
+	  *   stopbit	- stop bit duration
+	  *   engine	- time-table engine
+	  *																		*/
+	template<clock_t clock, clock_t baudrate, typename driver,
+		stopbits stopbit = stopbits::one, timetable engine = timetable::greedy>
+	struct parallel {
+		using timing = transmitter<clock, baudrate, driver, stopbit, engine>;
+		template<uint8_t bit>
+		using t = typename timing::template row<bit>;
+		template<cycle_t period_ic>
+		using delay = typename timing::template delay<period_ic>;
+		static constexpr uint8_t channels = driver::channels;
+
+		/** send one byte per channel, data[0] goes to the lowest pin	*/
+		__attribute__((optimize("-Os")))
+		static volatile void send(const uint8_t* data) {
+			uint8_t image[10];	/* port images for all bit slots		*/
+			driver::prepare(image, data);
+			const uint8_t* slot = image;
+			driver::start(slot);
+			delay<t<0>::wait>::cycles();
+			driver::send(slot);
+			delay<t<1>::wait>::cycles();
+			driver::send(slot);
+			delay<t<2>::wait>::cycles();
+			driver::send(slot);
+			delay<t<3>::wait>::cycles();
+			driver::send(slot);
+			delay<t<4>::wait>::cycles();
+			driver::send(slot);
+			delay<t<5>::wait>::cycles();
+			driver::send(slot);
+			delay<t<6>::wait>::cycles();
+			driver::send(slot);
+			delay<t<7>::wait>::cycles();
+			driver::send(slot);
+			delay<t<8>::wait>::cycles();
+			driver::stop(slot);
+			delay<t<9>::wait>::cycles();
+		}
+
+		/** initialize the lines (call the driver)						*/
+		static inline void init() {
+			driver::init();
+		}
+	};
+	/** configuration solver, evaluates transmitter time-tables for any
+	 *  baudrate at compile time
+	  * params
+	  *   clock		- system cloc, Hz
+	  *   driver	- class, implementing hardware specific line control
+	  *   stopbit	- stop bit duration used for frame length
+	  * thresholds are given in per mille of bit duration					*/
+	template<clock_t clock, typename driver, stopbits stopbit = stopbits::one>
+	struct best {
+		using mcu = typename driver::mcu;
+		static constexpr auto cpi = mcu::cpi;
+		static constexpr milicycle_t permille = 1000LL;
+		static constexpr milicycle_t default_threshold = permille / 5;
+		static constexpr cycle_t max_wait = mcu::template delay<0>::max;
+
+		/** transmitter the solver evaluates for the baudrate				*/
+		template<clock_t baudrate, stopbits sb = stopbit>
+		using table = hast::transmitter<clock, baudrate, driver, sb>;
+
+		/** worst bit error in per mille of bit duration, rounded			*/
+		template<clock_t baudrate>
+		static constexpr milicycle_t error() {
+			return estimate<baudrate>::error;
+		}
+		/** true if the baudrate is within driver limits and threshold	*/
+		template<clock_t baudrate>
+		static constexpr bool valid(milicycle_t threshold = default_threshold) {
+			return estimate<baudrate>::error <= threshold
+				&& estimate<baudrate>::error <= default_threshold;
+		}
+		/** frame duration in cycles, start bit to the end of stop bit,
+		 *  the baudrate must be valid										*/
+		template<clock_t baudrate>
+		static constexpr cycle_t frame_cycles() {
+			return table<baudrate>::template t<table<baudrate>::stop_slot>::rfinish;
+		}
+		/** stop bit duration in cycles for the given setting				*/
+		template<clock_t baudrate, stopbits sb>
+		static constexpr cycle_t stop_cycles() {
+			return table<baudrate, sb>::template t<table<baudrate, sb>::stop_slot>::rfinish
+				- table<baudrate, sb>::template t<table<baudrate, sb>::stop_slot>::rstart;
+		}
+		/** shortest stop bit setting that lasts past the receiver's
+		 *  mid-stop sampling point with the given error margin			*/
+		template<clock_t baudrate>
+		static constexpr stopbits stopbit_for(milicycle_t threshold = default_threshold) {
+			static_assert(baudrate != 0, "no baudrate within threshold for this clock/driver");
+			return shortest<baudrate>::stop(threshold);
+		}
+
+		/** fastest valid rate among the given ones, 0 if none			*/
+		template<clock_t ... rates>
+		static constexpr clock_t fastest_of(milicycle_t threshold = default_threshold) {
+			return select<rates...>::fastest(threshold);
+		}
+		/** fastest valid standard baudrate, 0 if none					*/
+		static constexpr clock_t fastest(milicycle_t threshold = default_threshold) {
+			return fastest_of<_9600, _19200, _38400, _57600,
+				_115200, _230400, _460800, _921600>(threshold);
+		}
+
+		/** fastest valid standard baudrate and its transmitter			*/
+		template<milicycle_t threshold>
+		struct pick {
+			static constexpr clock_t rate = fastest(threshold);
+			static_assert(rate != 0, "no baudrate within threshold for this clock/driver");
+			using type = hast::transmitter<clock, rate, driver,
+				stopbit_for<rate>(threshold)>;
+		};
+		/** transmitter with the fastest valid standard baudrate			*/
+		template<milicycle_t threshold = default_threshold>
+		using transmitter = typename pick<threshold>::type;
+
+	private:
+		static constexpr milicycle_t milicycles_per_bit(clock_t baudrate) {
+			return (mili * clock / cpi) / baudrate;
+		}
+		static constexpr milicycle_t max(milicycle_t a, milicycle_t b) {
+			return a < b ? b : a;
+		}
+
+		/* worst error of the bits from the given one, milicycles, a whole
+		 * bit if the time-table is not feasible. Made of the table's own
+		 * functions, the steps of t<bit> without its checks, so a rate the
+		 * transmitter rejects can be probed without failing the build	*/
+		template<typename tx, uint8_t bit = 0, cycle_t rstart = 0,
+			bool last = (bit >= tx::stop_slot)>
+		struct probe {
+			static constexpr cycle_t cycles = tx::bitcycles(bit);
+			static constexpr cycle_t length = schedule<tx, timetable::greedy>::
+				template length<bit>(rstart, tx::bitfinish(bit));
+			static constexpr cycle_t wait = length < cycles ? 0 : length - cycles;
+			static constexpr cycle_t rfinish = rstart + wait + cycles;
+			static constexpr milicycle_t worst =
+				length < cycles || wait > max_wait ? tx::milicycles_per_bit
+				: max(abs(tx::bitfinish(bit) - mili * rfinish),
+					  probe<tx, bit + 1, rfinish>::worst);
+		};
+		template<typename tx, uint8_t bit, cycle_t rstart>
+		struct probe<tx, bit, rstart, true> {
+			static constexpr milicycle_t worst = 0;
+		};
+
+		/* rates out of the driver and delay limits fail the transmitter's
+		 * own checks, they are not instantiated							*/
+		template<clock_t baudrate, bool in_range = (baudrate > 0)
+			&& milicycles_per_bit(baudrate) >= mili * driver::send_cycles
+			&& milicycles_per_bit(baudrate) <= mili * max_wait>
+		struct estimate {
+			static constexpr milicycle_t error = permille;
+		};
+		template<clock_t baudrate>
+		struct estimate<baudrate, true> {
+			using tx = table<baudrate>;
+			static constexpr milicycle_t error =
+				(probe<tx>::worst * permille + tx::milicycles_per_bit / 2)
+				/ tx::milicycles_per_bit;
+		};
+
+		template<clock_t baudrate, uint8_t sb = 0,
+			bool last = (sb >= static_cast<uint8_t>(stopbits::one))>
+		struct shortest {
+			static constexpr stopbits stop(milicycle_t threshold) {
+				return mili * stop_cycles<baudrate, static_cast<stopbits>(sb)>() >=
+					(milicycles_per_bit(baudrate) * (permille/2 + threshold)) / permille
+					? static_cast<stopbits>(sb)
+					: shortest<baudrate, sb + 1>::stop(threshold);
+			}
+		};
+		template<clock_t baudrate, uint8_t sb>
+		struct shortest<baudrate, sb, true> {
+			static constexpr stopbits stop(milicycle_t) {
+				return static_cast<stopbits>(sb);
+			}
+		};
+
+		template<clock_t ... rates>
+		struct select {
+			static constexpr clock_t fastest(milicycle_t) { return 0; }
+		};
+		template<clock_t rate, clock_t ... rates>
+		struct select<rate, rates...> {
+			static constexpr clock_t fastest(milicycle_t threshold) {
+				return valid<rate>(threshold) &&
+					   rate > select<rates...>::fastest(threshold)
+					? rate : select<rates...>::fastest(threshold);
+			}
+		};
+	};
+
+	/** list of clocks, Hz, for multi_transmitter						*/
+	template<clock_t ... c>
+	struct clocks {};
+	/** list of baudrates for multi_transmitter							*/
+	template<clock_t ... b>
+	struct bauds {};
+
+	/* i-th value of the list												*/
+	inline constexpr clock_t nth(uint8_t, clock_t v) {
+		return v;
+	}
+	template<typename ... T>
+	inline constexpr clock_t nth(uint8_t i, clock_t v, clock_t w, T ... r) {
+		return i == 0 ? v : nth(i - 1, w, r...);
+	}
+
+	/** transmitter with baudrate and clock selected at run time
+	 *  Time-tables of all clock x baud combinations are built at compile
+	 *  time, each combination is a frame function in a jump table. Data
+	 *  is prepared and the start edge is sent once by the common code,
+	 *  the call takes the beginning of the start bit padding. select()
+	 *  stores the index
+	  * params
+	  *   clock_list	- hast::clocks<...>
+	  *   baud_list	- hast::bauds<...>
+	  *   others		- as in hast::transmitter
+	  *																		*/
+	template<typename clock_list, typename baud_list, typename driver,
+		stopbits stopbit = stopbits::one, timetable engine = timetable::greedy,
+		typename format = frame<>>
+	struct multi_transmitter;
+
+	template<clock_t ... c, clock_t ... b, typename driver, stopbits stopbit,
+		timetable engine, typename format>
+	struct multi_transmitter<clocks<c...>, bauds<b...>, driver, stopbit, engine, format> {
+		using mcu = typename driver::mcu;
+		using data_t = typename format::data_t;
+		static constexpr uint8_t baud_count = sizeof...(b);
+		/** number of clock x baud combinations							*/
+		static constexpr uint8_t count = sizeof...(c) * sizeof...(b);
+		/** driver of the combinations, the start bit padding begins
+		 *  with the call from the common code							*/
+		struct called : driver {
+			static constexpr cycle_t start_cycles =
+				driver::start_cycles + mcu::call_cycles;
+		};
+		/** transmitter of combination i									*/
+		template<uint8_t i>
+		using variant = transmitter<nth(i / baud_count, c...),
+			nth(i % baud_count, b...), called, stopbit, engine, format>;
+
+		/** index of the combination, compile time, count if the clock
+		 *  and baudrate are not in the lists								*/
+		static constexpr uint8_t index_of(clock_t clock, clock_t baudrate,
+				uint8_t i = 0) {
+			return i >= count ? count :
+				nth(i / baud_count, c...) == clock && nth(i % baud_count, b...) == baudrate
+				? i : index_of(clock, baudrate, i + 1);
+		}
+
+		/** initialize the line (call the driver)							*/
+		static inline void init() {
+			driver::init();
+		}
+		/** select combination by clock and baud indexes in the lists
+		 *  returns false and keeps the selection if an index is out of range*/
+		static inline bool select(uint8_t clock_index, uint8_t baud_index) {
+			return clock_index < sizeof...(c) && baud_index < baud_count
+				&& select(clock_index * baud_count + baud_index);
+		}
+		/** select combination by its index
+		 *  returns false and keeps the selection if index >= count		*/
+		static inline bool select(uint8_t index) {
+			if( index >= count ) return false;
+			selected = index;
+			return true;
+		}
+		/** send one byte of data with the selected combination			*/
+		__attribute__((optimize("-Os")))
+		static void send(data_t data) {
+			const uint16_t bits = format::wire(data, true);
+			const frame_t finish =
+				mcu::flash(&table<typename make_indices<count>::type>::frames[selected]);
+			if( format::bits > 8 )
+				driver::extend(((bits ^ (bits << 1)) >> 8) & 1);
+			driver::start(bits);
+			mcu::call(finish, bits);
+		}
+
+	private:
+		using frame_t = void (*)(uint16_t);
+		template<typename list>
+		struct table;
+		template<uint8_t ... i>
+		struct table<indices<i...>> {
+			static const frame_t frames[sizeof...(i)];
+		};
+		static uint8_t selected;
+		static_assert(count > 0, "Empty clock or baud list");
+		static_assert(! driver::whole_frame,
+			"Driver sends whole frames, multi_transmitter sends bit by bit");
+	};
+
+	template<clock_t ... c, clock_t ... b, typename driver, stopbits stopbit,
+		timetable engine, typename format>
+	template<uint8_t ... i>
+	const typename multi_transmitter<clocks<c...>, bauds<b...>, driver, stopbit,
+		engine, format>::frame_t
+	multi_transmitter<clocks<c...>, bauds<b...>, driver, stopbit, engine, format>::
+		table<indices<i...>>::frames[sizeof...(i)] HAST_PROGMEM = {
+		&variant<i>::finish...
+	};
+
+	template<clock_t ... c, clock_t ... b, typename driver, stopbits stopbit,
+		timetable engine, typename format>
+	uint8_t multi_transmitter<clocks<c...>, bauds<b...>, driver, stopbit, engine,
+		format>::selected = 0;
+
+	/* delay of any length, in chunks of mcu::delay::max					*/
+	template<typename mcu, cycle_t period,
+		bool fits = (period <= mcu::template delay<0>::max)>
+	struct stretch {
+		__attribute__((always_inline))
+		static inline void cycles() {
+			mcu::template delay<period>::cycles();
+		}
+	};
+	template<typename mcu, cycle_t period>
+	struct stretch<mcu, period, false> {
+		__attribute__((always_inline))
+		static inline void cycles() {
+			mcu::template delay<mcu::template delay<0>::max>::cycles();
+			stretch<mcu, period - mcu::template delay<0>::max>::cycles();
+		}
+	};
+
+	/* i-th type of the list												*/
+	template<uint8_t i, typename T, typename ... R>
+	struct nth_type : nth_type<i - 1, R...> {};
+	template<typename T, typename ... R>
+	struct nth_type<0, T, R...> { using type = T; };
+
+	/** channel of hast::interleaved
+	  * params
+	  *   baudrate	- UART baudrate, baud
+	  *   driver	- class, implementing the lane_* line control
+	  *   stopbit	- stop bit duration
+	  *																		*/
+	template<clock_t baudrate, typename driver, stopbits stopbit = stopbits::one>
+	struct channel {
+		static constexpr clock_t baud = baudrate;
+		static constexpr stopbits stop = stopbit;
+		using line = driver;
+	};
+
+	/** interleaved transmitter, sends one 8N1 byte per channel at once,
+	 *  channels may have different baudrates and ports. Edges of all
+	 *  channels are merged into one list sorted by ideal time at compile
+	 *  time and driven by one unrolled routine. Edges of the same port,
+	 *  closer than the cost of a separate write, share one out, written
+	 *  in the middle of their ideal times. Sending takes the longest
+	 *  frame instead of the sum of the frames
+	  * params
+	  *   clock		- system clock, Hz
+	  *   channels	- hast::channel<...>, up to mcu::lanes
+	  *																		*/
+	template<clock_t clock, typename ... channels>
+	struct interleaved {
+		using mcu = typename nth_type<0, channels...>::type::line::mcu;
+		static constexpr auto cpi = mcu::cpi;
+		/** number of channels											*/
+		static constexpr uint8_t count = sizeof...(channels);
+		/** edges of a frame: start, 8 data bits, stop					*/
+		static constexpr uint8_t edges = 10;
+		/** edges of all channels										*/
+		static constexpr uint8_t events = count * edges;
+		/** driver of channel c											*/
+		template<uint8_t c>
+		using line = typename nth_type<c, channels...>::type::line;
+
+		/** initialize all lines (call the drivers)						*/
+		static inline void init() {
+			lanes<0>::init();
+		}
+
+		/** send data[c] on channel c, for all channels
+		 *  NOTE: interrupts are blocked for the longest frame			*/
+		__attribute__((optimize("-Os")))
+		static void send(const uint8_t* data) {
+			lanes<0>::load(data);
+			const uint8_t sreg = mcu::disable_interrupts();
+			lanes<0>::read();
+			emit<0>::run();
+			mcu::restore_interrupts(sreg);
+			stretch<mcu, tail>::cycles();
+		}
+
+		/** ideal bit length of channel c, milicycles					*/
+		static constexpr milicycle_t bit(uint8_t c) {
+			return static_cast<milicycle_t>((mili * clock / cpi) / nth(c, channels::baud...));
+		}
+		/** ideal end of the stop bit of channel c, milicycles			*/
+		static constexpr milicycle_t finish(uint8_t c) {
+			return bit(c) * (edges - 1) + (bit(c) *
+				static_cast<milicycle_t>(nth(c, static_cast<clock_t>(channels::stop)...))) / 2;
+		}
+		/** end of the longest frame, milicycles							*/
+		static constexpr milicycle_t longest(uint8_t c = 0) {
+			return c + 1 >= count ? finish(c)
+				: finish(c) > longest(c + 1) ? finish(c) : longest(c + 1);
+		}
+		/** port of channel c											*/
+		static constexpr uint8_t port(uint8_t c) {
+			return static_cast<uint8_t>(nth(c, channels::line::lane_port...));
+		}
+		/** first channel on the port of channel c, owns the port image	*/
+		static constexpr uint8_t owner(uint8_t c, uint8_t i = 0) {
+			return port(i) == port(c) ? i : owner(c, i + 1);
+		}
+
+		/** ideal time of edge (id % edges) of channel (id / edges)		*/
+		static constexpr milicycle_t at(uint8_t id) {
+			return bit(id / edges) * (id % edges);
+		}
+		/** position of the edge in the merged list, ties go by channel	*/
+		static constexpr uint8_t rank(uint8_t id, uint8_t j = 0) {
+			return j >= events ? 0 : (at(j) < at(id) || (at(j) == at(id) && j < id)
+				? 1 : 0) + rank(id, j + 1);
+		}
+		/** edge at position k of the merged list							*/
+		static constexpr uint8_t sorted(uint8_t k, uint8_t id = 0) {
+			return id >= events || rank(id) == k ? id : sorted(k, id + 1);
+		}
+
+		/** edge k of the merged list										*/
+		template<uint8_t k>
+		struct event {
+			static constexpr uint8_t channel = sorted(k) / edges;
+			/** 0 - start, 1..8 - data bits, 9 - stop						*/
+			static constexpr uint8_t edge = sorted(k) % edges;
+			static constexpr uint8_t port = interleaved::port(channel);
+			static constexpr milicycle_t ideal = at(sorted(k));
+			static constexpr bool constant = edge == 0 || edge == edges - 1;
+			/** cycles to set the level in the port image					*/
+			static constexpr cycle_t cycles = constant
+				? line<channel>::lane_level_cycles : line<channel>::lane_bit_cycles;
+		};
+
+		/** recursion terminator										*/
+		struct none {
+			static constexpr uint8_t port = 0xFF;
+			static constexpr milicycle_t ideal = 0;
+			static constexpr uint8_t mask = 0;
+		};
+
+		/** edge k joins the write of the previous edge if both are on
+		 *  the same port, closer than a separate write would take and
+		 *  the channel has no edge in that write yet						*/
+		template<uint8_t k, bool end = (k >= events)>
+		struct group;
+		template<uint8_t k>
+		using grouped = group<k>;
+		template<uint8_t k, bool end>
+		struct group {
+			using before = prev<k, event, none>;
+			using last = prev<k, grouped, none>;
+			static constexpr bool joins = before::port == event<k>::port
+				&& event<k>::ideal - before::ideal < mili * (event<k>::cycles + 1)
+				&& ! (last::mask & (1 << event<k>::channel));
+			/** channels in the write so far								*/
+			static constexpr uint8_t mask =
+				(joins ? last::mask : 0) | (1 << event<k>::channel);
+		};
+		template<uint8_t k>
+		struct group<k, true> {
+			static constexpr bool joins = false;
+		};
+
+		/** edges from k to the end of its write							*/
+		template<uint8_t k, bool end = (k >= events)>
+		struct span {
+			/** cycles to the write, inclusive								*/
+			static constexpr cycle_t cycles = event<k>::cycles + (group<k + 1>::joins
+				? span<k + 1>::cycles : line<event<k>::channel>::lane_write_cycles);
+			/** ideal time of the last edge of the write					*/
+			static constexpr milicycle_t last = group<k + 1>::joins
+				? span<k + 1>::last : event<k>::ideal;
+		};
+		template<uint8_t k>
+		struct span<k, true> {
+			static constexpr cycle_t cycles = 0;
+			static constexpr milicycle_t last = 0;
+		};
+
+		/** recursion terminator, the first write is the time origin		*/
+		struct t0 {
+			static constexpr cycle_t rfinish = -span<0>::cycles;
+			static constexpr cycle_t out = 0;
+		};
+
+		/** merged time-table, edge k of the list						*/
+		template<uint8_t k>
+		struct t {
+			/** edge opens a write, the padding goes before it				*/
+			static constexpr bool first = ! group<k>::joins;
+			/** edge closes the write										*/
+			static constexpr bool closes = ! group<k + 1>::joins;
+			/** cycles to actuate the edge									*/
+			static constexpr cycle_t cycles = event<k>::cycles +
+				(closes ? line<event<k>::channel>::lane_write_cycles : 0);
+			/** ideal time of the write, middle of its edges				*/
+			static constexpr milicycle_t target = (event<k>::ideal + span<k>::last) / 2;
+			static constexpr cycle_t rstart = prev<k, t, t0>::rfinish;
+			/** padding before the edge										*/
+			static constexpr cycle_t wait = ! first ||
+				target - mili * rstart < mili * span<k>::cycles ? 0
+				: (target - mili * rstart + mili / 2) / mili - span<k>::cycles;
+			static constexpr cycle_t rfinish = rstart + wait + cycles;
+			/** time of the write that sets the edge						*/
+			static constexpr cycle_t out = first
+				? rstart + wait + span<k>::cycles : prev<k, t, t0>::out;
+			/** absolute error in milicycles								*/
+			static constexpr milicycle_t error = abs(event<k>::ideal - mili * out);
+			static_warn(error <= bit(event<k>::channel) / 5,
+				"Edge error exceeds 20%, use lower baudrates or fewer channels");
+		};
+
+		/** stop bit padding after the last edge							*/
+		static constexpr cycle_t tail =
+			(longest() + mili / 2) / mili - t<events - 1>::rfinish < 0 ? 0
+			: (longest() + mili / 2) / mili - t<events - 1>::rfinish;
+
+	private:
+		/** per channel setup, data is loaded before interrupts are
+		 *  disabled, port images after									*/
+		template<uint8_t c, bool end = (c >= count)>
+		struct lanes {
+			__attribute__((always_inline))
+			static inline void init() {
+				line<c>::lane_init();
+				lanes<c + 1>::init();
+			}
+			__attribute__((always_inline))
+			static inline void load(const uint8_t* data) {
+				line<c>::template lane_load<mcu::lane_data(c)>(data[c]);
+				lanes<c + 1>::load(data);
+			}
+			__attribute__((always_inline))
+			static inline void read() {
+				if( owner(c) == c )
+					line<c>::template lane_read<mcu::lane_image(owner(c))>();
+				lanes<c + 1>::read();
+			}
+		};
+		template<uint8_t c>
+		struct lanes<c, true> {
+			__attribute__((always_inline))
+			static inline void init() {}
+			__attribute__((always_inline))
+			static inline void load(const uint8_t*) {}
+			__attribute__((always_inline))
+			static inline void read() {}
+		};
+
+		/** emit edges from k to the end of the list						*/
+		template<uint8_t k, bool end = (k >= events)>
+		struct emit {
+			using e = event<k>;
+			using driver = line<e::channel>;
+			static constexpr uint8_t image = mcu::lane_image(owner(e::channel));
+			__attribute__((always_inline))
+			static inline void run() {
+				stretch<mcu, t<k>::wait>::cycles();
+				if( e::constant )
+					driver::template lane_level<image, e::edge != 0>();
+				else
+					driver::template lane_bit<mcu::lane_data(e::channel),
+						(e::edge - 1) & 7, image>();
+				if( t<k>::closes )
+					driver::template lane_write<image>();
+				emit<k + 1>::run();
+			}
+		};
+		template<uint8_t k>
+		struct emit<k, true> {
+			__attribute__((always_inline))
+			static inline void run() {}
+		};
+
+		static_assert(count > 0 && count <= mcu::lanes,
+			"Interleaved transmitter supports 1 to mcu::lanes channels");
+	};
+
+	/** lock-free single-producer/single-consumer ring buffer
+	 *  size must be a power of two, one element is kept free				*/
+	template<typename T, uint8_t size>
+	struct ring {
+		/** non-blocking put, returns false if the buffer is full		*/
+		inline bool put(T value) {
+			const uint8_t h = head;
+			const uint8_t next = (h + 1) & (size - 1);
+			if( next == tail ) return false;
+			data[h] = value;
+			asm volatile ("" ::: "memory"); /* data before head			*/
+			head = next;
+			return true;
+		}
+		/** non-blocking get, returns false if the buffer is empty		*/
+		inline bool get(T& value) {
+			const uint8_t t = tail;
+			if( t == head ) return false;
+			value = data[t];
+			asm volatile ("" ::: "memory"); /* data before tail			*/
+			tail = (t + 1) & (size - 1);
+			return true;
+		}
+		inline bool empty() const {
+			return head == tail;
+		}
+	private:
+		static_assert(size >= 2 && (size & (size - 1)) == 0,
+			"Ring size must be a power of two");
+		volatile uint8_t head;
+		volatile uint8_t tail;
+		T data[size];
+	};
+
+	/** interrupt driven asynchronous transmitter
+	 *  Each edge of the transmitter's time-table is emitted by a short
+	 *  timer compare ISR, CPU is free between edges. The application
+	 *  must bind the timer's compare vector to isr(), e.g.
+	 *    ISR(TIMER0_COMPA_vect) { async::isr(); }
+	  * params
+	  *   tx		- hast::transmitter, provides time-table, driver and format
+	  *   timer		- timer with compare unit, e.g. avr::timer0<8>
+	  *   size		- ring buffer size, power of two
+	  *   isr_cycles- worst case ISR duration, including prologue/epilogue
+	  *   blocking	- worst case time other ISRs may delay this one, cycles
+	  *																		*/
+	template<typename tx, typename timer, uint8_t size = 16,
+		cycle_t isr_cycles = 60, cycle_t blocking = 0>
+	struct async {
+		using driver = typename tx::line;
+		using mcu = typename tx::mcu;
+		using format = typename tx::frame_t;
+		using data_t = typename format::data_t;
+		using bits_t = typename word<(format::bits > 8)>::type;
+		using count_t = typename timer::count_t;
+		static constexpr uint8_t stop_edge = format::bits + 1;
+		static constexpr uint8_t frame_end = format::bits + 2;
+
+		/** initialize the line and the timer							*/
+		static inline void init() {
+			driver::init();
+			timer::init();
+		}
+
+		/** queue data for transmission, returns false if queue is full	*/
+		static bool write(data_t data) {
+			if( ! queue.put(format::wire(data, true)) ) return false;
+			if( ! busy ) {
+				const uint8_t sreg = mcu::disable_interrupts();
+				if( ! busy ) {
+					busy = true;
+					event = frame_end;
+					timer::schedule(lead);
+				}
+				mcu::restore_interrupts(sreg);
+			}
+			return true;
+		}
+
+		/** true while there is data on the line or in the queue			*/
+		static inline bool active() {
+			return busy;
+		}
+
+		/** timer compare handler, emits one edge per call				*/
+		static inline void isr() {
+			uint8_t e = event;
+			if( e <= format::bits ) {
+				driver::put(bits & 1);
+				bits >>= 1;
+			} else if( e == stop_edge ) {
+				driver::put(1);
+			} else {
+				bits_t next;
+				if( ! queue.get(next) ) {
+					timer::disable();
+					busy = false;
+					return;
+				}
+				driver::put(0);
+				bits = next;
+				e = 0;
+			}
+			timer::advance(ticks<typename make_indices<frame_end>::type>::delta[e]);
+			event = e + 1;
+		}
+
+		/** edge time in timer ticks, 0 is the start edge				*/
+		template<uint8_t e>
+		struct edge {
+			/* edge e finishes slot e-1 of the time-table				*/
+			using slot = typename tx::template row<(e == 0 ? 0 : e - 1)>;
+			static constexpr cycle_t cycles = e == 0 ? 0 : slot::rfinish;
+			static constexpr milicycle_t ideal = e == 0 ? 0 : slot::mfinish;
+			static constexpr milicycle_t tick = mili * timer::prescaler;
+			static constexpr cycle_t at = (cycles + timer::prescaler/2) / timer::prescaler;
+			/** edge error including latency jitter, milicycles			*/
+			static constexpr milicycle_t error = abs(ideal - tick * at)
+				+ mili * (mcu::isr_jitter_cycles + blocking);
+			static_warn(e == frame_end || error <= tx::milicycles_per_bit / 5,
+				"ISR latency makes baudrate infeasible, use different (lower) baudrate");
+		};
+
+	private:
+		template<typename list>
+		struct ticks;
+		template<uint8_t ... e>
+		struct ticks<indices<e...>> {
+			static const count_t delta[sizeof...(e)];
+		};
+
+		static constexpr milicycle_t ticks_per_bit =
+			tx::milicycles_per_bit / timer::prescaler;
+		/** ticks from write to the start edge, the compare must not
+		 *  match before schedule clears its flag, whatever the phase of
+		 *  the prescaler											*/
+		static constexpr count_t lead =
+			(timer::schedule_cycles + timer::prescaler - 1) / timer::prescaler + 1;
+		static_warn(ticks_per_bit <= mili * timer::max_count,
+			"Timer prescaler is too small for the baudrate");
+		static_warn(ticks_per_bit >= mili * 2,
+			"Timer prescaler is too large for the baudrate");
+		static_warn(mili * (isr_cycles + mcu::isr_entry_cycles + blocking)
+				< tx::milicycles_per_bit,
+			"ISR does not fit into a bit, use different (lower) baudrate");
+
+		static ring<bits_t, size> queue;
+		static volatile bool busy;
+		static volatile uint8_t event;
+		static bits_t bits;
+	};
+
+	template<typename tx, typename timer, uint8_t size, cycle_t isr_cycles, cycle_t blocking>
+	template<uint8_t ... e>
+	const typename timer::count_t
+	async<tx, timer, size, isr_cycles, blocking>::ticks<indices<e...>>::delta[sizeof...(e)] = {
+		static_cast<count_t>(edge<e+1>::at - edge<e>::at)...
+	};
+
+	template<typename tx, typename timer, uint8_t size, cycle_t isr_cycles, cycle_t blocking>
+	ring<typename async<tx, timer, size, isr_cycles, blocking>::bits_t, size>
+	async<tx, timer, size, isr_cycles, blocking>::queue;
+
+	template<typename tx, typename timer, uint8_t size, cycle_t isr_cycles, cycle_t blocking>
+	volatile bool async<tx, timer, size, isr_cycles, blocking>::busy;
+
+	template<typename tx, typename timer, uint8_t size, cycle_t isr_cycles, cycle_t blocking>
+	volatile uint8_t async<tx, timer, size, isr_cycles, blocking>::event;
+
+	template<typename tx, typename timer, uint8_t size, cycle_t isr_cycles, cycle_t blocking>
+	typename async<tx, timer, size, isr_cycles, blocking>::bits_t
+	async<tx, timer, size, isr_cycles, blocking>::bits;
+
+	/** Packet encodings													*/
+	enum class encoding : uint8_t {
+		cobs,		/** consistent overhead byte stuffing, 0x00 delimited	*/
+		slip		/** RFC 1055, 0xC0 delimited, 0xDB escaped				*/
+	};
+
+	/** CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) of one byte		*/
+	inline uint16_t crc16_ccitt(uint16_t crc, uint8_t byte) {
+		uint8_t x = (crc >> 8) ^ byte;
+		x ^= x >> 4;
+		return (crc << 8) ^ (static_cast<uint16_t>(x) << 12)
+			^ (static_cast<uint16_t>(x) << 5) ^ x;
+	}
+
+	/** state of a packet in memory, shared by hast::packet and the
+	 *  fixed cost steps it runs in the bit padding, see avr::packet_steps*/
+	struct packet_cursor {
+		uint16_t crc;			/* CRC over the payload up to crc_at		*/
+		const uint8_t* crc_at;	/* next payload byte for the CRC			*/
+		const uint8_t* scan_at;	/* next payload byte for the COBS scan	*/
+		const uint8_t* end;		/* end of the payload						*/
+		uint8_t run;			/* non-zero bytes found in the COBS block	*/
+		uint8_t open;			/* 1 while the scan may extend the block	*/
+	};
+
+	/** packet framer, streams payload and its CRC-16/CCITT, big endian,
+	 *  through tx with COBS or SLIP encoding and a trailing delimiter.
+	 *  CRC and the COBS scan for the next block run as mcu::packet_steps
+	 *  in the bit padding of the frames being sent (send<work>), as many
+	 *  per frame as fit. What the steps have not done when it is needed
+	 *  is finished in C between frames, at high rates that is all of it.
+	 *  No encoded copy of the payload is kept in RAM
+	  * params
+	  *   tx		- hast::transmitter with 8-bit data
+	  *   enc		- encoding
+	  *																		*/
+	template<typename tx, encoding enc = encoding::cobs>
+	struct packet {
+		static constexpr uint8_t delimiter = enc == encoding::cobs ? 0x00 : 0xC0;
+		static_assert(sizeof(typename tx::data_t) == 1,
+			"Packet framer requires 8-bit data");
+
+		/** send n bytes of data as one packet							*/
+		static void send(const uint8_t* data, uint16_t n) {
+			cur.crc = 0xFFFF;
+			cur.crc_at = data;
+			cur.scan_at = data;
+			cur.end = data + n;
+			cur.run = 0;
+			cur.open = 1;
+			encoder<enc>::send(data, n);
+			out(delimiter);
+		}
+
+		/** steps run in the padding of each frame, 0 if none fits		*/
+		static constexpr uint8_t steps_per_frame() {
+			return most<>::value;
+		}
+
+	private:
+		static packet_cursor cur;
+		using steps = typename tx::mcu::template packet_steps<cur>;
+
+		/** CRC steps, interleaved with COBS scan steps					*/
+		template<uint8_t count>
+		struct work {
+			static constexpr uint8_t slices = count;
+			static constexpr cycle_t cost(uint8_t i) {
+				return enc == encoding::cobs && (i & 1)
+					? steps::scan_cycles : steps::crc_cycles;
+			}
+			template<uint8_t i>
+			__attribute__((always_inline))
+			static inline void slice() {
+				if( enc == encoding::cobs && (i & 1) )
+					steps::scan();
+				else
+					steps::crc();
+			}
+		};
+		/* the most steps that fit into a frame, up to 64					*/
+		template<uint8_t count = 0, bool more = (count < 64 &&
+			! tx::line::whole_frame && tx::template fits<work<count + 1>>())>
+		struct most {
+			static constexpr uint8_t value = most<count + 1>::value;
+		};
+		template<uint8_t count>
+		struct most<count, false> {
+			static constexpr uint8_t value = count;
+		};
+
+		template<bool padded, int = 0>
+		struct sender {
+			static inline void send(uint8_t c) {
+				tx::template send<work<steps_per_frame()>>(c);
+			}
+		};
+		template<int dummy>
+		struct sender<false, dummy> {
+			static inline void send(uint8_t c) {
+				tx::send(c);
+			}
+		};
+		static inline void out(uint8_t c) {
+			sender<(steps_per_frame() > 0)>::send(c);
+		}
+
+		/** CRC of the payload the steps have not covered yet			*/
+		static inline void finish_crc() {
+			while( cur.crc_at != cur.end )
+				cur.crc = crc16_ccitt(cur.crc, *cur.crc_at++);
+		}
+		/** byte i of the payload followed by its CRC					*/
+		static inline uint8_t at(const uint8_t* data, uint16_t n, uint16_t i) {
+			if( i < n ) return data[i];
+			finish_crc();
+			return i == n ? cur.crc >> 8 : cur.crc & 0xFF;
+		}
+
+		template<encoding, int = 0>
+		struct encoder;
+
+		/** COBS, each block is preceded by the distance to the next zero.
+		 *  The scan for the next block starts when the code byte of the
+		 *  current one is sent, so it runs in the padding of the current
+		 *  block's frames. C finishes it, and scans the CRC bytes		*/
+		template<int dummy>
+		struct encoder<encoding::cobs, dummy> {
+			static void send(const uint8_t* data, uint16_t n) {
+				uint16_t pos = 0;
+				uint8_t tail = 0; /* CRC bytes passed by the scan			*/
+				for(;;) {
+					while( cur.open ) { /* same as steps::scan			*/
+						uint8_t c;
+						if( cur.scan_at != cur.end )
+							c = *cur.scan_at;
+						else if( tail < 2 )
+							c = at(data, n, n + tail);
+						else {
+							cur.open = 0;
+							break;
+						}
+						if( c == 0 ) {
+							cur.open = 0;
+						} else {
+							if( cur.scan_at != cur.end ) ++cur.scan_at;
+							else ++tail;
+							if( ++cur.run == 254 ) cur.open = 0;
+						}
+					}
+					const uint8_t len = cur.run;
+					const bool zero = pos + len < n + 2 && len < 254;
+					if( zero ) { /* the scan resumes past the zero		*/
+						if( cur.scan_at != cur.end ) ++cur.scan_at;
+						else ++tail;
+					}
+					cur.run = 0;
+					cur.open = 1;
+					out(len + 1);
+					for(uint8_t i = 0; i < len; ++i)
+						out(at(data, n, pos + i));
+					pos += len + zero;
+					if( pos >= n + 2 && ! zero ) break;
+				}
+			}
+		};
+
+		/** SLIP, leading END flushes line noise at the receiver			*/
+		template<int dummy>
+		struct encoder<encoding::slip, dummy> {
+			static constexpr uint8_t end = 0xC0;
+			static constexpr uint8_t esc = 0xDB;
+			static void send(const uint8_t* data, uint16_t n) {
+				out(end);
+				for(uint16_t i = 0; i < n + 2; ++i) {
+					const uint8_t c = at(data, n, i);
+					if( c == end || c == esc ) {
+						out(esc);
+						out(c == end ? 0xDC : 0xDD);
+					} else
+						out(c);
+				}
+			}
+		};
+	};
+
+	template<typename tx, encoding enc>
+	packet_cursor packet<tx, enc>::cur;
+
+	/** deferred binary log, sends format string ID and raw arguments in a
+	 *  COBS packet, text is rendered on the host by extras/hast_log.cpp.
+	 *  Use with HAST_LOG macro, which keeps format strings in .hast_log
+	 *  section, not loaded to the flash; ID is the string offset there.
+	 *  Arguments are sent as is, little endian, the format must match
+	 *  their exact size, e.g. %hhu for uint8_t, %u for int16_t on AVR
+	  * params
+	  *   tx		- hast::transmitter with 8-bit data
+	  *																		*/
+	template<typename tx>
+	struct log {
+		/** send a log record											*/
+		template<typename ... T>
+		static void write(uint16_t id, const T& ... args) {
+			uint8_t record[sizeof(id) + size<T...>()];
+			pack(record, id, args...);
+			packet<tx, encoding::cobs>::send(record, sizeof(record));
+		}
+
+	private:
+		template<typename ... T>
+		static constexpr uint16_t size() {
+			return sum(sizeof(T)...);
+		}
+		static constexpr uint16_t sum() { return 0; }
+		template<typename ... N>
+		static constexpr uint16_t sum(uint16_t n, N ... r) { return n + sum(r...); }
+
+		static inline void pack(uint8_t*) {}
+		template<typename A, typename ... R>
+		static inline void pack(uint8_t* p, const A& arg, const R& ... rest) {
+			const uint8_t* v = reinterpret_cast<const uint8_t*>(&arg);
+			for(uint8_t i = 0; i < sizeof(A); ++i)
+				*p++ = v[i];
+			pack(p, rest...);
+		}
+	};
+
+	/** waveform template - bit-banged protocols with pulse-width symbols
+	  * params
+	  *   clock		- system clock, Hz
+	  *   driver	- class, implementing the wave_* line control
+	  *   spec		- protocol specification, see protocol
+	  * A packet is the preamble phases, then one frame per byte, then the
+	  * tail. A frame is spec::lead fixed symbols, spec::bits data symbols
+	  * and spec::trail fixed symbols. A symbol of bit b starts with level
+	  * spec::first(b) for spec::pulse(b) ns and holds the opposite level
+	  * to the end of spec::period, so edges of a symbol are at fixed times
+	  * and each edge is a fixed level or the (inverted) data bit			*/
+	template<clock_t clock, typename driver, typename spec>
+	struct waveform {
+		using mcu = typename driver::mcu;
+		static constexpr auto cpi = mcu::cpi;
+		/** symbols in a frame											*/
+		static constexpr uint8_t symbols = spec::lead + spec::bits + spec::trail;
+		/** shorter and longer first level of a symbol, ns				*/
+		static constexpr time_t shorter =
+			spec::pulse(0) < spec::pulse(1) ? spec::pulse(0) : spec::pulse(1);
+		static constexpr time_t longer =
+			spec::pulse(0) < spec::pulse(1) ? spec::pulse(1) : spec::pulse(0);
+		/** edges in a symbol: start, end of shorter and longer pulse		*/
+		static constexpr uint8_t edges = 1 + (shorter < spec::period ? 1 : 0)
+			+ (longer > shorter && longer < spec::period ? 1 : 0);
+		/** index of the next frame's first edge							*/
+		static constexpr uint8_t frame_end = symbols * edges;
+
+		template<cycle_t period_ic>
+		struct delay : mcu::template delay<period_ic> {};
+
+		/** set the line to the idle level								*/
+		static inline void init() {
+			driver::template wave_init<spec::idle>();
+		}
+
+		/** send n bytes as one packet, frames follow back to back
+		 *  NOTE: interrupts are blocked for the whole packet				*/
+		__attribute__((optimize("-Os")))
+		static void send(const uint8_t* data, uint16_t n) {
+			if( n == 0 ) return;
+			driver::wave_begin(data);
+			preamble<0>::run();
+			for(;;) { /* sbiw, breq, wave_next, rjmp - wave_next_cycles	*/
+				emit<0>::run();
+				stretch<t<frame_end>::wait>::cycles();
+				if( --n == 0 ) break;
+				driver::wave_next(data);
+			}
+			driver::wave_end();
+			stretch<cycles(spec::tail)>::cycles();
+		}
+
+		/** cycles of a time in ns, rounded								*/
+		static constexpr cycle_t cycles(time_t ns) {
+			return (ns * static_cast<time_t>(clock / cpi) + nano / 2) / nano;
+		}
+		/** time in ns of milicycles										*/
+		static constexpr time_t ns(milicycle_t mc) {
+			return (mc * nano) / (mili * static_cast<time_t>(clock / cpi));
+		}
+		/** level of the symbol of bit at offs ns from its start			*/
+		static constexpr uint8_t level(uint8_t bit, time_t offs) {
+			return offs < spec::pulse(bit) ? spec::first(bit) : ! spec::first(bit);
+		}
+		/** offset of the kind of edge in the symbol, ns					*/
+		static constexpr time_t offset(uint8_t kind) {
+			return kind == 0 ? 0 : kind == 2 || shorter >= spec::period ? longer : shorter;
+		}
+		/** fixed value of the symbol, or -1 for a data bit				*/
+		static constexpr int8_t fixed(uint8_t symbol) {
+			return symbol < spec::lead ? spec::fixed(symbol)
+				: symbol < spec::lead + spec::bits ? -1
+				: spec::fixed(symbol - spec::bits);
+		}
+		/** data bit of the symbol										*/
+		static constexpr uint8_t data_bit(uint8_t symbol) {
+			return spec::msb ? spec::lead + spec::bits - 1 - symbol : symbol - spec::lead;
+		}
+
+		/** edge of the frame, edge 0 is the start of the first symbol	*/
+		template<uint8_t e>
+		struct edge {
+			static constexpr uint8_t symbol = (e % frame_end) / edges;
+			static constexpr time_t offs = offset((e % frame_end) % edges);
+			static constexpr int8_t value = fixed(symbol);
+			/** levels of bit 0 and bit 1 after the edge					*/
+			static constexpr uint8_t low = level(value < 0 ? 0 : value, offs);
+			static constexpr uint8_t high = level(value < 0 ? 1 : value, offs);
+			static constexpr bool constant = low == high;
+			/** cycles to actuate the edge									*/
+			static constexpr cycle_t cycles = constant
+				? driver::wave_level_cycles : driver::wave_bit_cycles;
+			/** ideal time in milicycles, from the frame start				*/
+			static constexpr milicycle_t ideal = mili
+				* ((symbol + (e / frame_end) * symbols) * spec::period + offs)
+				* static_cast<time_t>(clock / cpi) / nano;
+			__attribute__((always_inline))
+			static inline void run() {
+				if( constant )
+					driver::template wave_level<high>();
+				else
+					driver::template wave_bit<data_bit(symbol) & 7, high == 0>();
+			}
+		};
+
+		/** recursion terminator, edge 0 is at the frame start			*/
+		struct t0 {
+			static constexpr cycle_t rfinish = 0;
+		};
+
+		/** waveform time-table, edge 0 is the frame origin				*/
+		template<uint8_t e>
+		struct t {
+			/** cycles to actuate the edge, the next frame's first edge
+			 *  also loads the next byte and loops							*/
+			static constexpr cycle_t cycles = e == 0 ? 0 : e == frame_end
+				? driver::wave_next_cycles + edge<0>::cycles : edge<e>::cycles;
+			static constexpr milicycle_t mfinish = edge<e>::ideal;
+			static constexpr cycle_t rstart = prev<e, t, t0>::rfinish;
+			/** nearest feasible length										*/
+			static constexpr cycle_t length =
+				(mfinish - mili * rstart + mili / 2) / mili < cycles ? cycles
+				: (mfinish - mili * rstart + mili / 2) / mili;
+			static constexpr cycle_t wait = length - cycles;
+			static constexpr cycle_t rfinish = rstart + length;
+			/** absolute error in milicycles								*/
+			static constexpr milicycle_t error = abs(mfinish - mili * rfinish);
+			static_warn(e == frame_end || ns(error) <= spec::tolerance,
+				"Edge error exceeds protocol tolerance, use higher clock");
+			static_warn(e != frame_end || ns(error) <= spec::tolerance + spec::slack,
+				"Frame gap exceeds protocol tolerance, use higher clock");
+		};
+
+	private:
+		/** emit edges from e to the frame end, exclusive					*/
+		template<uint8_t e, bool last = (e == frame_end)>
+		struct emit {
+			__attribute__((always_inline))
+			static inline void run() {
+				if( e != 0 )
+					stretch<t<e == 0 ? 1 : e>::wait>::cycles();
+				edge<e>::run();
+				emit<e + 1>::run();
+			}
+		};
+		template<uint8_t e>
+		struct emit<e, true> {
+			__attribute__((always_inline))
+			static inline void run() {}
+		};
+
+		template<cycle_t period>
+		using stretch = hast::stretch<mcu, period>;
+
+		/** start of the preamble phase, cycles							*/
+		static constexpr cycle_t phase_start(uint8_t p) {
+			return p == 0 ? 0 : cycles(spec::length(p - 1)) + phase_start(p - 1);
+		}
+		/** preamble phases from p, each is a fixed level				*/
+		template<uint8_t p, bool last = (p >= spec::phases)>
+		struct preamble {
+			static constexpr cycle_t next = p + 1 < spec::phases
+				? driver::wave_level_cycles : edge<0>::cycles;
+			static constexpr cycle_t wait = phase_start(p + 1) - phase_start(p) - next;
+			__attribute__((always_inline))
+			static inline void run() {
+				driver::template wave_level<spec::level(p)>();
+				stretch<wait < 0 ? 0 : wait>::cycles();
+				preamble<p + 1>::run();
+			}
+			static_warn(wait >= 0, "Preamble phase is too short for the clock");
+		};
+		template<uint8_t p>
+		struct preamble<p, true> {
+			__attribute__((always_inline))
+			static inline void run() {}
+		};
+
+		static_assert(spec::bits > 0 && spec::bits <= 8,
+			"Waveform frames carry 1 to 8 data bits");
+		static_assert(spec::pulse(0) > 0 && spec::pulse(1) > 0 &&
+			spec::pulse(0) <= spec::period && spec::pulse(1) <= spec::period,
+			"Pulse must be within the symbol period");
+		static_assert(level(fixed(symbols - 1) < 0 ? 0 : fixed(symbols - 1),
+			spec::period - 1) == spec::idle && level(fixed(symbols - 1) < 0 ? 1
+			: fixed(symbols - 1), spec::period - 1) == spec::idle,
+			"Frame must end at the idle level");
+	};
+
+	/** Protocol specifications for hast::waveform, durations in ns		*/
+	struct protocol {
+		/** WS2812 LED strips, 800 kHz, GRB bytes MSB first				*/
+		struct ws2812 {
+			static constexpr uint8_t idle = 0;
+			static constexpr uint8_t bits = 8;
+			static constexpr bool msb = true;
+			static constexpr uint8_t lead = 0;
+			static constexpr uint8_t trail = 0;
+			static constexpr uint8_t fixed(uint8_t) { return 0; }
+			static constexpr time_t period = 1250;
+			static constexpr uint8_t first(uint8_t) { return 1; }
+			static constexpr time_t pulse(uint8_t bit) { return bit ? 800 : 400; }
+			static constexpr uint8_t phases = 0;
+			static constexpr uint8_t level(uint8_t) { return 0; }
+			static constexpr time_t length(uint8_t) { return 0; }
+			static constexpr time_t tail = 50000;		/* latch			*/
+			static constexpr time_t tolerance = 150;
+			static constexpr time_t slack = 4000;		/* low between bytes*/
+		};
+
+		/** 1-Wire write slots after a reset pulse, standard speed. The
+		 *  presence pulse is not sampled. For open drain, see inverted	*/
+		struct onewire {
+			static constexpr uint8_t idle = 1;
+			static constexpr uint8_t bits = 8;
+			static constexpr bool msb = false;
+			static constexpr uint8_t lead = 0;
+			static constexpr uint8_t trail = 0;
+			static constexpr uint8_t fixed(uint8_t) { return 0; }
+			static constexpr time_t period = 70000;	/* A+B or C+D			*/
+			static constexpr uint8_t first(uint8_t) { return 0; }
+			static constexpr time_t pulse(uint8_t bit) { return bit ? 6000 : 60000; }
+			static constexpr uint8_t phases = 2;		/* reset, presence	*/
+			static constexpr uint8_t level(uint8_t p) { return p; }
+			static constexpr time_t length(uint8_t) { return 480000; }
+			static constexpr time_t tail = 10000;
+			static constexpr time_t tolerance = 1000;
+			static constexpr time_t slack = 10000;
+		};
+
+		/** DMX-512 packet: break, mark after break, start code and slots
+		 *  as 250 kbaud 8N2 frames										*/
+		struct dmx512 {
+			static constexpr uint8_t idle = 1;
+			static constexpr uint8_t bits = 8;
+			static constexpr bool msb = false;
+			static constexpr uint8_t lead = 1;
+			static constexpr uint8_t trail = 2;
+			static constexpr uint8_t fixed(uint8_t i) { return i == 0 ? 0 : 1; }
+			static constexpr time_t period = 4000;
+			static constexpr uint8_t first(uint8_t bit) { return bit; }
+			static constexpr time_t pulse(uint8_t) { return period; }
+			static constexpr uint8_t phases = 2;		/* break, MAB		*/
+			static constexpr uint8_t level(uint8_t p) { return p; }
+			static constexpr time_t length(uint8_t p) { return p ? 12000 : 176000; }
+			static constexpr time_t tail = 0;
+			static constexpr time_t tolerance = 800;	/* 20% of a bit		*/
+			static constexpr time_t slack = 1000000;	/* mark between slots*/
+		};
+
+		/** 8N1 UART frames, MARK is the high level						*/
+		template<clock_t baudrate>
+		struct uart {
+			static constexpr uint8_t idle = 1;
+			static constexpr uint8_t bits = 8;
+			static constexpr bool msb = false;
+			static constexpr uint8_t lead = 1;
+			static constexpr uint8_t trail = 1;
+			static constexpr uint8_t fixed(uint8_t i) { return i == 0 ? 0 : 1; }
+			static constexpr time_t period = nano / baudrate;
+			static constexpr uint8_t first(uint8_t bit) { return bit; }
+			static constexpr time_t pulse(uint8_t) { return period; }
+			static constexpr uint8_t phases = 0;
+			static constexpr uint8_t level(uint8_t) { return 1; }
+			static constexpr time_t length(uint8_t) { return 0; }
+			static constexpr time_t tail = 0;
+			static constexpr time_t tolerance = period / 5;
+			static constexpr time_t slack = nano;
+		};
+
+		/** spec with inverted levels, e.g. for open drain lines driven
+		 *  through DDRx														*/
+		template<typename spec>
+		struct inverted : spec {
+			static constexpr uint8_t idle = ! spec::idle;
+			static constexpr uint8_t first(uint8_t bit) { return ! spec::first(bit); }
+			static constexpr uint8_t level(uint8_t p) { return ! spec::level(p); }
+		};
+	};
+
+	
+	/************************************************************************/
+	/** AVR-specific concerns												*/
+	struct avr {
+		static constexpr cycle_t cpi = 1; /* clock per instruction			*/
+		static constexpr cycle_t branch_cycles = 4; /* subi, breq, rjmp	*/
+		static constexpr cycle_t isr_entry_cycles = 7; /* response, jmp	*/
+		static constexpr cycle_t isr_jitter_cycles = 4; /* longest insn	*/
+
+		/** disable interrupts, return previous SREG					*/
+		__attribute__((always_inline))
+		static inline uint8_t disable_interrupts() {
+			uint8_t sreg;
+			asm volatile ("in %0, __SREG__\n cli" : "=r"(sreg) :: "memory");
+			return sreg;
+		}
+		__attribute__((always_inline))
+		static inline void restore_interrupts(uint8_t sreg) {
+			asm volatile ("out __SREG__, %0" :: "r"(sreg) : "memory");
+		}
+		/** call a routine taken from a table, arg in r25:r24 as the ABI
+		 *  passes it. The routine starts call_cycles after the call		*/
+#ifdef __AVR_3_BYTE_PC__
+		static constexpr cycle_t call_cycles = 4; /* icall				*/
+#else
+		static constexpr cycle_t call_cycles = 3; /* icall				*/
+#endif
+		__attribute__((always_inline))
+		static inline void call(void (*routine)(uint16_t), uint16_t arg) {
+#ifdef __AVR__
+			register uint16_t pair asm("r24") = arg;
+			asm volatile ("icall" : "+z" (routine), "+r" (pair)
+						 :: "r0", "r18", "r19", "r20", "r21", "r22", "r23",
+						 "r26", "r27", "cc", "memory");
+#else
+			routine(arg);
+#endif
+		}
+		/** read a pointer from a HAST_PROGMEM table					*/
+		template<typename T>
+		__attribute__((always_inline))
+		static inline T flash(const T* p) {
+#ifdef __AVR__
+			return reinterpret_cast<T>(pgm_read_word(p));
+#else
+			return *p;
+#endif
+		}
+		using sfr = volatile uint8_t;
+		/** delay loops with 3 (short) and 6 (long) ic per iteration 		*/
+		template<cycle_t period_ic, bool longloop>
+		struct loop;
+
+		/** 
+		 * Register usage:
+		 * r18 - loop count and work register
+		 * r19 - keeps __SREG__ (for the whole buffer in burst mode)
+		 * r20 - keeps port state
+		 * r21 - prepared data (data &= (data<<1))
+		 * r22 - toggle mask (1<<bit)
+		 * r23 - prepared ninth bit (9-bit frames), parity work register,
+		 *       next byte of a burst
+		 * r24 - timer poll (interrupt windows)
+		 * r25 - timer count at the start bit, an asm operand (interrupt
+		 *       windows)
+		 * Waveform mode:
+		 * r21 - data, r23 - inverted data, r19, r20 as above
+		 * Interleaved mode:
+		 * r21..r24 - data of channels 0..3, r25, r26, r27, r30 - port
+		 * images of the ports, owned by the first channel on the port
+		 */
+
+		/** interleaved mode: number of channels and their registers		*/
+		static constexpr uint8_t lanes = 4;
+		static constexpr uint8_t lane_data(uint8_t c) {
+			return 21 + c;
+		}
+		static constexpr uint8_t lane_image(uint8_t c) {
+			return c < 3 ? 25 + c : 30;
+		}
+
+		/** program memory taken by delay<period>, words					*/
+		static constexpr uint8_t delay_words(cycle_t period) {
+			return period <= 0 ? 0 : period <= 3 ? 1 : period <= 6 ? 2 :
+				period <= 9 ? 3 : period <= 11 ? 4 :
+				period > 255*3 ? 4 + delay_words(period % 6) : 3 + delay_words(period % 3);
+		}
+
+		/** delay injector 													*/
+		template<cycle_t period_ic>	
+		struct delay {
+			static constexpr cycle_t max = 255*6 + 2;
+			static constexpr cycle_t period = period_ic;
+			/** program memory taken, words								*/
+			static constexpr uint8_t words = delay_words(period_ic);
+			__attribute__((always_inline)) 
+			static inline volatile void cycles() {
+				loop<period_ic, longloop>::cycles();
+			}
+			static_warn(period_ic <= max, "Delay too long");
+		private:
+			static constexpr bool longloop = period_ic > (255*3);
+		};
+
+		/* delay as an assembler macro for delays inside an asm statement:
+		 * hast_wait cycles, reg - the same code as delay<cycles>, counting
+		 * in reg (ldi-capable). Each statement defines and purges it		*/
+#define HAST_ASM_WAIT														\
+			".macro hast_wait cycles, reg\n"								\
+			".if \\cycles > 765\n"											\
+			" ldi \\reg, \\cycles / 6\n"										\
+			"1: lpm\n dec \\reg\n brne 1b\n"								\
+			" hast_wait_rest (\\cycles%%6)\n"								\
+			".elseif \\cycles > 11\n"										\
+			" ldi \\reg, \\cycles / 3\n"										\
+			"1: dec \\reg\n brne 1b\n"										\
+			" hast_wait_rest (\\cycles%%3)\n"								\
+			".else\n"														\
+			" hast_wait_rest \\cycles\n"									\
+			".endif\n"														\
+			".endm\n"														\
+			".macro hast_wait_rest cycles\n"								\
+			".rept \\cycles / 3\n lpm\n .endr\n"								\
+			".if \\cycles %% 3 == 1\n nop\n"									\
+			".elseif \\cycles %% 3 == 2\n rjmp .\n"							\
+			".endif\n"														\
+			".endm\n"
+#define HAST_ASM_WAIT_END ".purgem hast_wait\n .purgem hast_wait_rest"
+
+		/** PORT driver - uses out to drive the pin							*/
+		template<uint8_t port, uint8_t ddr, uint8_t pin, uint8_t space = uart_space_level>
+		struct driver {
+			/* NOTE: driver disables interrupts on start and enables on stop
+					 driver uses the following sequence to send a bit:
+						sbrc (data), (bit)
+						eor  r20, (1<<bit)
+						out  (port), r20									*/
+			using mcu = avr;  /* hast::trasmitter uses mcu::delay			*/
+			static constexpr cycle_t send_cycles  = 3; /* sbrc, eor, out	*/
+			static constexpr cycle_t start_cycles = 0; /* nothing after out */
+			static constexpr cycle_t stop_cycles  = 2; /* ori, out			*/
+			static constexpr cycle_t fetch_cycles = 5; /* ld, mov, lsl, eor	*/
+			static constexpr cycle_t restart_cycles = 3; /* mov, andi/ori,
+									out of resume						*/
+			static constexpr cycle_t take_cycles = 1; /* mov, not after a
+									fetch in the stop bit				*/
+			static constexpr cycle_t loop_setup_cycles = 1; /* ldi		*/
+			static constexpr cycle_t loop_cycles = 5; /* lsr, ror, dec, brne*/
+			static constexpr cycle_t reload_cycles = 1; /* in after a window*/
+			/** bits are sent one by one, see preload_driver				*/
+			static constexpr bool whole_frame = false;
+			/** cycles to compute parity of n data bits					*/
+			template<uint8_t n, bool odd>
+			static constexpr cycle_t parity_cycles() {
+				return 12 + (odd ? 1 : 0) + (n < 8 ? 2 : 0);
+			}
+
+			/** initialize port for output									*/
+			__attribute__((always_inline)) 
+			static inline void init() {
+				if( space == 0 )
+					asm volatile ("sbi %0,%2\n sbi %1, %2" 
+								 :: "I" (port), "I" (ddr), "I" (pin): "memory");
+				else
+					asm volatile ("cbi %0,%2\n sbi %1, %2" 
+								 :: "I" (port), "I" (ddr), "I" (pin): "memory");
+			}
+
+			/** prepare data, disable interrupts, send start bit 			*/
+			__attribute__((always_inline)) 
+			static inline void start(uint8_t data) {
+				begin(data);
+				resume();
+			}
+			/** prepare data, disable interrupts, resume sends the start bit*/
+			__attribute__((always_inline)) 
+			static inline void begin(uint8_t data) {
+				asm volatile ("mov r18, %0\n mov r21, r18" 
+							 ::"r"(data) : "cc", "r18", "r21", "memory");
+				asm volatile ("lsl r18\n eor r21, r18\n ldi r22,%0" 
+							 ::"M"(1<<pin): "cc", "r18", "r21", "r22", "memory");
+				if( space == 0 )
+					asm volatile ("in r20, %0\n andi r20,~%1\n in r19, __SREG__\n cli"
+								 ::"I" (port), "M"(1<<pin) : "cc", "r20", "r19", "memory");
+				else
+					asm volatile ("in r20, %0\n ori  r20,%1\n in r19, __SREG__\n cli"
+								 ::"I" (port), "M"(1<<pin) : "cc", "r20", "r19", "memory");
+			}
+			/** send start bit prepared by begin or restart					*/
+			__attribute__((always_inline)) 
+			static inline void resume() {
+				asm volatile ("out %0, r20" ::"I" (port) : "r20", "memory");
+			}
+			/** send a bit 															*/
+			template<uint8_t bit>
+			__attribute__((always_inline))
+			static inline void send(uint8_t data) {
+				if( bit < 8 )
+					asm volatile ("sbrc r21, %0\n eor r20, r22\n out %1, r20" 
+								 :: "I" (bit & 7), "I" (port): "r21", "r22", "memory");
+				else
+					asm volatile ("sbrc r23, 0\n eor r20, r22\n out %0, r20"
+								 :: "I" (port): "r23", "r22", "memory");
+			}
+			/** send n bits in a loop, shifting r23:r21, pad runs after each
+			 *  bit (compact mode). One asm statement, so the loop label,
+			 *  the counter and the pad stay under its control				*/
+			template<uint8_t n, typename pad>
+			__attribute__((always_inline))
+			static inline void loop() {
+				uint8_t count, wait;
+				asm volatile (HAST_ASM_WAIT
+							  "ldi %[count], %[n]\n"
+							  "7: sbrc r21, 0\n eor r20, r22\n out %[port], r20\n"
+							  "hast_wait %[pad], %[wait]\n"
+							  "lsr r23\n ror r21\n dec %[count]\n brne 7b\n"
+							  HAST_ASM_WAIT_END
+							 : [count] "=&d" (count), [wait] "=&d" (wait)
+							 : [n] "M" (n), [port] "I" (port), [pad] "n" (pad::period)
+							 : "cc", "r20", "r21", "r22", "r23", "memory");
+			}
+			/** capture the timer count after start (interrupt windows)	*/
+			template<typename timer>
+			__attribute__((always_inline))
+			static inline uint8_t capture() {
+				return timer::capture();
+			}
+			/** interrupt window, resynchronised with the timer. An ISR may
+			 *  have written the port, so the image is read back			*/
+			template<typename timer, uint8_t target>
+			__attribute__((always_inline))
+			static inline void window(uint8_t origin) {
+				timer::template window<target>(origin);
+				asm volatile ("in r20, %0" ::"I" (port) : "r20", "memory");
+			}
+			/** waveform: cycles of a fixed level, a data bit level, loading
+			 *  the next byte and looping									*/
+			static constexpr cycle_t wave_level_cycles = 2; /* ori, out	*/
+			static constexpr cycle_t wave_bit_cycles = 3; /* bst, bld, out	*/
+			static constexpr cycle_t wave_next_cycles = 9; /* sbiw, breq of
+									the loop, ld, mov, com, rjmp		*/
+			/** set the pin to the level, output. For open drain pass DDRx
+			 *  as both port and ddr, the PORTx bit must be 0				*/
+			template<uint8_t level>
+			__attribute__((always_inline))
+			static inline void wave_init() {
+				if( level )
+					asm volatile ("sbi %0, %1" :: "I" (port), "I" (pin): "memory");
+				else
+					asm volatile ("cbi %0, %1" :: "I" (port), "I" (pin): "memory");
+				if( ddr != port )
+					asm volatile ("sbi %0, %1" :: "I" (ddr), "I" (pin): "memory");
+			}
+			/** load the first byte, disable interrupts					*/
+			__attribute__((always_inline))
+			static inline void wave_begin(const uint8_t*& data) {
+				asm volatile ("ld r21, %a0+\n mov r23, r21\n com r23\n"
+							  "in r20, %1\n in r19, __SREG__\n cli"
+							 : "+e"(data) : "I" (port)
+							 : "cc", "r19", "r20", "r21", "r23", "memory");
+			}
+			/** set a fixed level											*/
+			template<uint8_t level>
+			__attribute__((always_inline))
+			static inline void wave_level() {
+				if( level )
+					asm volatile ("ori r20, %1\n out %0, r20"
+								 :: "I" (port), "M"(1<<pin) : "cc", "r20", "memory");
+				else
+					asm volatile ("andi r20, ~%1\n out %0, r20"
+								 :: "I" (port), "M"(1<<pin) : "cc", "r20", "memory");
+			}
+			/** set the level of the data bit, inverted if invert			*/
+			template<uint8_t bit, bool invert>
+			__attribute__((always_inline))
+			static inline void wave_bit() {
+				if( invert )
+					asm volatile ("bst r23, %0\n bld r20, %1\n out %2, r20"
+								 :: "I" (bit), "I" (pin), "I" (port) : "r20", "r23", "memory");
+				else
+					asm volatile ("bst r21, %0\n bld r20, %1\n out %2, r20"
+								 :: "I" (bit), "I" (pin), "I" (port) : "r20", "r21", "memory");
+			}
+			/** load the next byte, the frame loop counts and branches		*/
+			__attribute__((always_inline))
+			static inline void wave_next(const uint8_t*& data) {
+				asm volatile ("ld r21, %a0+\n mov r23, r21\n com r23"
+							 : "+e"(data) :: "cc", "r21", "r23", "memory");
+			}
+			/** restore interrupts											*/
+			__attribute__((always_inline))
+			static inline void wave_end() {
+				asm volatile ("out __SREG__, r19" ::: "r19", "memory");
+			}
+			/** interleaved mode: port, cycles of a fixed level, a data
+			 *  bit and the port write, see hast::interleaved				*/
+			static constexpr uint8_t lane_port = port;
+			static constexpr uint8_t lane_pin = pin;
+			static constexpr cycle_t lane_level_cycles = 1; /* ori/andi	*/
+			static constexpr cycle_t lane_bit_cycles = 2; /* bst, bld		*/
+			static constexpr cycle_t lane_write_cycles = 1; /* out			*/
+			/** initialize port for output									*/
+			__attribute__((always_inline))
+			static inline void lane_init() {
+				init();
+			}
+			/** load data into register reg, inverted if SPACE is 1		*/
+			template<uint8_t reg>
+			__attribute__((always_inline))
+			static inline void lane_load(uint8_t data) {
+				asm volatile ("mov r%1, %0" ::"r"(data), "I" (reg)
+							 : "r21", "r22", "r23", "r24", "r25", "r26", "r27", "r30", "memory");
+				if( space )
+					asm volatile ("com r%0" ::"I" (reg)
+							 : "cc", "r21", "r22", "r23", "r24", "r25", "r26", "r27", "r30", "memory");
+			}
+			/** read the port into the image register						*/
+			template<uint8_t image>
+			__attribute__((always_inline))
+			static inline void lane_read() {
+				asm volatile ("in r%0, %1" ::"I" (image), "I" (port)
+							 : "r21", "r22", "r23", "r24", "r25", "r26", "r27", "r30", "memory");
+			}
+			/** set MARK (mark != 0) or SPACE in the image					*/
+			template<uint8_t image, uint8_t mark>
+			__attribute__((always_inline))
+			static inline void lane_level() {
+				if( (mark != 0) == (space == 0) )
+					asm volatile ("ori r%0, %1" ::"I" (image), "M"(1<<pin)
+							 : "cc", "r21", "r22", "r23", "r24", "r25", "r26", "r27", "r30", "memory");
+				else
+					asm volatile ("andi r%0, ~%1" ::"I" (image), "M"(1<<pin)
+							 : "cc", "r21", "r22", "r23", "r24", "r25", "r26", "r27", "r30", "memory");
+			}
+			/** copy the data bit into the image							*/
+			template<uint8_t data, uint8_t bit, uint8_t image>
+			__attribute__((always_inline))
+			static inline void lane_bit() {
+				asm volatile ("bst r%0, %1\n bld r%2, %3"
+							 ::"I" (data), "I" (bit), "I" (image), "I" (pin)
+							 : "r21", "r22", "r23", "r24", "r25", "r26", "r27", "r30", "memory");
+			}
+			/** write the image to the port									*/
+			template<uint8_t image>
+			__attribute__((always_inline))
+			static inline void lane_write() {
+				asm volatile ("out %0, r%1" ::"I" (port), "I" (image)
+							 : "r21", "r22", "r23", "r24", "r25", "r26", "r27", "r30", "memory");
+			}
+			/** set line to MARK (mark != 0) or SPACE (async mode)			*/
+			__attribute__((always_inline))
+			static inline void put(uint8_t mark) {
+				if( (mark != 0) == (space == 0) )
+					asm volatile ("sbi %0, %1" :: "I" (port), "I" (pin): "memory");
+				else
+					asm volatile ("cbi %0, %1" :: "I" (port), "I" (pin): "memory");
+			}
+			/** prepare the ninth bit toggle (9-bit frames), before start	*/
+			__attribute__((always_inline))
+			static inline void extend(uint8_t toggle) {
+				asm volatile ("mov r23, %0" ::"r"(toggle): "r23", "memory");
+			}
+			/** compute parity of the first n-1 bits into the toggle of
+			 *  bit n (r21 for n < 8, r23 for n == 8), runs after start		*/
+			template<uint8_t n, bool odd>
+			__attribute__((always_inline))
+			static inline void parity(uint8_t bits) {
+				asm volatile ("mov r18, %0\n andi r18, %1\n"
+							  "mov r23, r18\n swap r23\n eor r23, r18\n"
+							  "mov r18, r23\n lsr r18\n lsr r18\n eor r23, r18\n"
+							  "mov r18, r23\n lsr r18\n eor r23, r18"
+							 ::"r"(bits), "M"((1<<(n-1))-1): "cc", "r18", "r23", "memory");
+				if( odd )
+					asm volatile ("com r23" ::: "cc", "r23", "memory");
+				if( n < 8 )
+					asm volatile ("bst r23, 0\n bld r21, %0"
+								 ::"I" (n & 7): "r21", "r23", "memory");
+			}
+			/** send stop bit, enable interrupts				 					*/
+			__attribute__((always_inline))
+			static inline volatile void stop(uint8_t data) {
+				if( space == 0 )
+					asm volatile ("ori r20,%1\n out %0, r20\n out __SREG__, r19"
+								 ::"I" (port), "M"(1<<pin):"cc", "r20", "r19", "memory");
+				else
+					asm volatile ("andi r20,~%1\n out %0, r20\n out __SREG__, r19"
+								 ::"I" (port), "M"(1<<pin):"cc", "r20", "r19", "memory");
+			}
+			/** send stop bit, keep interrupts disabled (burst mode)			*/
+			__attribute__((always_inline))
+			static inline void hold() {
+				if( space == 0 )
+					asm volatile ("ori r20,%1\n out %0, r20"
+								 ::"I" (port), "M"(1<<pin):"cc", "r20", "memory");
+				else
+					asm volatile ("andi r20,~%1\n out %0, r20"
+								 ::"I" (port), "M"(1<<pin):"cc", "r20", "memory");
+			}
+			/** load and prepare next byte into r23, late in the stop bit
+			 *  right into r21 (burst mode)									*/
+			template<bool late = false>
+			__attribute__((always_inline))
+			static inline void fetch(const uint8_t*& data) {
+				if( late )
+					asm volatile ("ld r21, %a0+\n mov r18, r21\n lsl r18\n eor r21, r18"
+								 :"+e"(data) :: "cc", "r18", "r21", "memory");
+				else
+					asm volatile ("ld r23, %a0+\n mov r18, r23\n lsl r18\n eor r23, r18"
+								 :"+e"(data) :: "cc", "r18", "r23", "memory");
+			}
+			/** take the fetched byte, resume sends its start bit
+			 *  (burst mode)												*/
+			template<bool late = false>
+			__attribute__((always_inline))
+			static inline void restart() {
+				if( ! late )
+					asm volatile ("mov r21, r23" ::: "r21", "memory");
+				if( space == 0 )
+					asm volatile ("andi r20,~%0" ::"M"(1<<pin) : "cc", "r20", "memory");
+				else
+					asm volatile ("ori  r20,%0" ::"M"(1<<pin) : "cc", "r20", "memory");
+			}
+			/** enable interrupts at the end of burst							*/
+			__attribute__((always_inline))
+			static inline volatile void release() {
+				asm volatile ("out __SREG__, r19" ::: "r19", "memory");
+			}
+			/** end of the stop bit period, nothing to do for a plain line	*/
+			static constexpr cycle_t done_cycles = 0;
+			__attribute__((always_inline))
+			static inline void done() {}
+			/** send_P: cycles of the flash fetch and of the start edge		*/
+			static constexpr cycle_t fetch_P_cycles = 3; /* lpm			*/
+			static constexpr cycle_t restart_P_cycles = 2; /* andi/ori,
+									out of resume						*/
+			/** data preparation of start(), done at compile time for send_P	*/
+			static constexpr uint8_t prepare(uint8_t data) {
+				return static_cast<uint8_t>(data ^ (data << 1));
+			}
+			/** fetch the first prepared byte from flash, disable interrupts,
+			 *  resume sends the start bit (send_P)							*/
+			__attribute__((always_inline))
+			static inline void begin_P(const uint8_t*& data) {
+				asm volatile ("lpm r21, %a0+\n ldi r22,%1"
+							 :"+z"(data) :"M"(1<<pin) : "r21", "r22", "memory");
+				if( space == 0 )
+					asm volatile ("in r20, %0\n andi r20,~%1\n in r19, __SREG__\n cli"
+								 ::"I" (port), "M"(1<<pin) : "cc", "r20", "r19", "memory");
+				else
+					asm volatile ("in r20, %0\n ori  r20,%1\n in r19, __SREG__\n cli"
+								 ::"I" (port), "M"(1<<pin) : "cc", "r20", "r19", "memory");
+			}
+			/** fetch the next prepared byte from flash (send_P)				*/
+			__attribute__((always_inline))
+			static inline void fetch_P(const uint8_t*& data) {
+				asm volatile ("lpm r21, %a0+" :"+z"(data) :: "r21", "memory");
+			}
+			/** start bit image of the fetched byte, resume sends it (send_P)*/
+			__attribute__((always_inline))
+			static inline void restart_P() {
+				if( space == 0 )
+					asm volatile ("andi r20,~%0" ::"M"(1<<pin) : "cc", "r20", "memory");
+				else
+					asm volatile ("ori  r20,%0" ::"M"(1<<pin) : "cc", "r20", "memory");
+			}
+		private:
+			static_assert(space==0 || space==1, "Invalid space value. Valid values are: 0, 1");
+		};
+		
+		/** PINx toggle driver - writing 1 to PINx toggles the pin, so a bit
+		 *  takes two cycles and baudrate may reach CLOCK/2. Port state is
+		 *  not kept, other pins of the port may change while sending		*/
+		template<uint8_t pinx, uint8_t ddr, uint8_t port, uint8_t pin,
+				 uint8_t space = uart_space_level>
+		struct toggle_driver : driver<port, ddr, pin, space> {
+			/* NOTE: toggle_driver disables interrupts on start and enables
+					 on stop, it uses the following sequence to send a bit:
+						sbrc (data), (bit)
+						out  (pinx), r22
+					 r20 is not used											*/
+			static constexpr cycle_t send_cycles  = 2; /* sbrc, out		*/
+			static constexpr cycle_t start_cycles = 0; /* nothing after out */
+			static constexpr cycle_t stop_cycles  = 2; /* sbis, out		*/
+			static constexpr cycle_t restart_cycles = 2; /* mov, out of resume*/
+
+			/** prepare data, disable interrupts, send start bit 			*/
+			__attribute__((always_inline))
+			static inline void start(uint8_t data) {
+				begin(data);
+				resume();
+			}
+			/** prepare data, disable interrupts, resume sends the start bit*/
+			__attribute__((always_inline))
+			static inline void begin(uint8_t data) {
+				asm volatile ("mov r18, %0\n mov r21, r18"
+							 ::"r"(data) : "cc", "r18", "r21", "memory");
+				asm volatile ("lsl r18\n eor r21, r18\n ldi r22,%0"
+							 ::"M"(1<<pin): "cc", "r18", "r21", "r22", "memory");
+				asm volatile ("in r19, __SREG__\n cli" ::: "r19", "memory");
+			}
+			/** send start bit, toggles the pin								*/
+			__attribute__((always_inline))
+			static inline void resume() {
+				asm volatile ("out %0, r22" ::"I" (pinx) : "r22", "memory");
+			}
+			/** send a bit 													*/
+			template<uint8_t bit>
+			__attribute__((always_inline))
+			static inline void send(uint8_t data) {
+				if( bit < 8 )
+					asm volatile ("sbrc r21, %0\n out %1, r22"
+								 :: "I" (bit & 7), "I" (pinx): "r21", "r22", "memory");
+				else
+					asm volatile ("sbrc r23, 0\n out %0, r22"
+								 :: "I" (pinx): "r23", "r22", "memory");
+			}
+			/** send n bits in a loop (compact mode)						*/
+			template<uint8_t n, typename pad>
+			__attribute__((always_inline))
+			static inline void loop() {
+				uint8_t count, wait;
+				asm volatile (HAST_ASM_WAIT
+							  "ldi %[count], %[n]\n"
+							  "7: sbrc r21, 0\n out %[pinx], r22\n"
+							  "hast_wait %[pad], %[wait]\n"
+							  "lsr r23\n ror r21\n dec %[count]\n brne 7b\n"
+							  HAST_ASM_WAIT_END
+							 : [count] "=&d" (count), [wait] "=&d" (wait)
+							 : [n] "M" (n), [pinx] "I" (pinx), [pad] "n" (pad::period)
+							 : "cc", "r21", "r22", "r23", "memory");
+			}
+			/** interrupt window, toggles keep no port image to reload		*/
+			static constexpr cycle_t reload_cycles = 0;
+			template<typename timer, uint8_t target>
+			__attribute__((always_inline))
+			static inline void window(uint8_t origin) {
+				timer::template window<target>(origin);
+			}
+			/** send stop bit, enable interrupts							*/
+			__attribute__((always_inline))
+			static inline volatile void stop(uint8_t data) {
+				hold();
+				asm volatile ("out __SREG__, r19" ::: "r19", "memory");
+			}
+			/** send stop bit, keep interrupts disabled (burst mode)		*/
+			__attribute__((always_inline))
+			static inline void hold() {
+				/* PORTx reflects the toggle at once, PINx lags a cycle		*/
+				if( space == 0 )
+					asm volatile ("sbis %0, %1\n out %2, r22"
+								 ::"I" (port), "I" (pin), "I" (pinx): "r22", "memory");
+				else
+					asm volatile ("sbic %0, %1\n out %2, r22"
+								 ::"I" (port), "I" (pin), "I" (pinx): "r22", "memory");
+			}
+			/** take the fetched byte, resume sends its start bit
+			 *  (burst mode)												*/
+			template<bool late = false>
+			__attribute__((always_inline))
+			static inline void restart() {
+				if( ! late )
+					asm volatile ("mov r21, r23" ::: "r21", "memory");
+			}
+		};
+
+		/* asm text shared by preload_driver::frame and burst			*/
+#define HAST_PRELOAD_LEVELS													\
+			"in %[mark], %[port]\n"											\
+			".if %[spc]\n"													\
+			" andi %[mark], ~%[bit]\n mov %[space], %[mark]\n"				\
+			" ori %[space], %[bit]\n"										\
+			".else\n"														\
+			" ori %[mark], %[bit]\n mov %[space], %[mark]\n"				\
+			" andi %[space], ~%[bit]\n"										\
+			".endif\n"
+#define HAST_PRELOAD_IMAGE(k)												\
+			".if %[bits] > " #k "\n"										\
+			" mov %[i" #k "], %[space]\n sbrc %[byte], " #k "\n"			\
+			" mov %[i" #k "], %[mark]\n"									\
+			".endif\n"
+#define HAST_PRELOAD_IMAGES													\
+			HAST_PRELOAD_IMAGE(0) HAST_PRELOAD_IMAGE(1)						\
+			HAST_PRELOAD_IMAGE(2) HAST_PRELOAD_IMAGE(3)						\
+			HAST_PRELOAD_IMAGE(4) HAST_PRELOAD_IMAGE(5)						\
+			HAST_PRELOAD_IMAGE(6) HAST_PRELOAD_IMAGE(7)
+#define HAST_PRELOAD_BIT(k)													\
+			".if %[bits] > " #k "\n"										\
+			" hast_wait %[w" #k "], %[count]\n out %[port], %[i" #k "]\n"	\
+			".endif\n"
+#define HAST_PRELOAD_BITS													\
+			HAST_PRELOAD_BIT(0) HAST_PRELOAD_BIT(1)							\
+			HAST_PRELOAD_BIT(2) HAST_PRELOAD_BIT(3)							\
+			HAST_PRELOAD_BIT(4) HAST_PRELOAD_BIT(5)							\
+			HAST_PRELOAD_BIT(6) HAST_PRELOAD_BIT(7)							\
+			"hast_wait %[stop], %[count]\n out %[port], %[mark]\n"
+#define HAST_PRELOAD_PARITY_IMAGE(k)										\
+			".if %[par] == " #k "\n"										\
+			" sbrc %[count], 0\n mov %[i" #k "], %[mark]\n"					\
+			" sbrs %[count], 0\n mov %[i" #k "], %[space]\n"				\
+			".endif\n"
+
+		/** preloaded driver - port images of all bit slots are computed
+		 *  into registers before cli, a bit is a single out, so baudrate
+		 *  may reach CLOCK. Frames with up to 8 bits between start and stop
+		 *  are supported (e.g. 8N1, 7E1). The whole frame, or burst, is
+		 *  one asm statement, so images stay in registers the compiler
+		 *  has allocated. send<work>, send_compact, send_interruptible
+		 *  and send_P are not supported									*/
+		template<uint8_t port, uint8_t ddr, uint8_t pin, uint8_t space = uart_space_level>
+		struct preload_driver : driver<port, ddr, pin, space> {
+			/* NOTE: preload_driver disables interrupts on start and enables
+					 on stop, it uses the following sequence to send a bit:
+						out  (port), (image)
+					 paddings are hast_wait, see HAST_ASM_WAIT				*/
+			static constexpr cycle_t send_cycles  = 1; /* out				*/
+			static constexpr cycle_t start_cycles = 0; /* nothing after out */
+			static constexpr cycle_t stop_cycles  = 1; /* out				*/
+			static constexpr cycle_t restart_cycles = 27; /* ld,
+											8 x (mov, sbrc, mov), out		*/
+			static constexpr cycle_t fetch_cycles = 0; /* ld is in restart	*/
+			static constexpr cycle_t take_cycles = 0;
+			/** frames and bursts are sent by frame() and burst()			*/
+			static constexpr bool whole_frame = true;
+			/** cycles to compute parity of n data bits and set its image	*/
+			template<uint8_t n, bool odd>
+			static constexpr cycle_t parity_cycles() {
+				return 12 + (odd ? 1 : 0) + 4;
+			}
+
+			/** prepare images, disable interrupts, send the frame, see
+			 *  transmitter::layout, enable interrupts						*/
+			template<typename layout>
+			__attribute__((always_inline))
+			static inline void frame(uint8_t data) {
+				static_assert(layout::bits <= 8,
+					"preload_driver supports up to 8 bits between start and stop");
+				uint8_t i0, i1, i2, i3, i4, i5, i6, i7;
+				uint8_t mark, spc, count, work, sreg;
+				asm volatile (
+					HAST_ASM_WAIT
+					HAST_PRELOAD_LEVELS
+					HAST_PRELOAD_IMAGES
+					"in %[sreg], __SREG__\n cli\n out %[port], %[space]\n"
+					/* parity of the data bits into its image				*/
+					".if %[par]\n"
+					" mov %[work], %[byte]\n andi %[work], (1 << %[par]) - 1\n"
+					" mov %[count], %[work]\n swap %[count]\n eor %[count], %[work]\n"
+					" mov %[work], %[count]\n lsr %[work]\n lsr %[work]\n"
+					" eor %[count], %[work]\n"
+					" mov %[work], %[count]\n lsr %[work]\n eor %[count], %[work]\n"
+					" .if %[odd]\n com %[count]\n .endif\n"
+					HAST_PRELOAD_PARITY_IMAGE(5)
+					HAST_PRELOAD_PARITY_IMAGE(6)
+					HAST_PRELOAD_PARITY_IMAGE(7)
+					".endif\n"
+					HAST_PRELOAD_BITS
+					"out __SREG__, %[sreg]\n"
+					HAST_ASM_WAIT_END
+					: [i0] "=&r" (i0), [i1] "=&r" (i1), [i2] "=&r" (i2),
+					  [i3] "=&r" (i3), [i4] "=&r" (i4), [i5] "=&r" (i5),
+					  [i6] "=&r" (i6), [i7] "=&r" (i7),
+					  [mark] "=&d" (mark), [space] "=&d" (spc),
+					  [count] "=&d" (count), [work] "=&d" (work),
+					  [sreg] "=&r" (sreg)
+					: [byte] "r" (data), [port] "I" (port), [bit] "M" (1<<pin),
+					  [spc] "n" (space), [bits] "n" (layout::bits),
+					  [par] "n" (layout::parity), [odd] "n" (layout::odd),
+					  [w0] "n" (layout::w0), [w1] "n" (layout::w1),
+					  [w2] "n" (layout::w2), [w3] "n" (layout::w3),
+					  [w4] "n" (layout::w4), [w5] "n" (layout::w5),
+					  [w6] "n" (layout::w6), [w7] "n" (layout::w7),
+					  [stop] "n" (layout::stop)
+					: "cc", "memory");
+			}
+
+			/** send n > 0 frames back-to-back, the next byte is loaded and
+			 *  prepared in the stop bit padding, the loop branch precedes
+			 *  the start edge, see transmitter::burst						*/
+			template<typename layout>
+			__attribute__((always_inline))
+			static inline void burst(const uint8_t* data, uint8_t n) {
+				static_assert(layout::bits == 8,
+					"Burst mode requires 8N1 frame format");
+				uint8_t i0, i1, i2, i3, i4, i5, i6, i7;
+				uint8_t mark, spc, count, byte, sreg;
+				asm volatile (
+					HAST_ASM_WAIT
+					HAST_PRELOAD_LEVELS
+					"ld %[byte], %a[ptr]+\n"
+					HAST_PRELOAD_IMAGES
+					"in %[sreg], __SREG__\n cli\n"
+					"2: out %[port], %[space]\n"
+					HAST_PRELOAD_BITS
+					"dec %[n]\n breq 3f\n"
+					"hast_wait %[gap], %[count]\n"
+					"ld %[byte], %a[ptr]+\n"
+					HAST_PRELOAD_IMAGES
+					"rjmp 2b\n"
+					"3: out __SREG__, %[sreg]\n"
+					HAST_ASM_WAIT_END
+					: [i0] "=&r" (i0), [i1] "=&r" (i1), [i2] "=&r" (i2),
+					  [i3] "=&r" (i3), [i4] "=&r" (i4), [i5] "=&r" (i5),
+					  [i6] "=&r" (i6), [i7] "=&r" (i7),
+					  [mark] "=&d" (mark), [space] "=&d" (spc),
+					  [count] "=&d" (count), [byte] "=&r" (byte),
+					  [sreg] "=&r" (sreg), [ptr] "+e" (data), [n] "+r" (n)
+					: [port] "I" (port), [bit] "M" (1<<pin),
+					  [spc] "n" (space), [bits] "n" (layout::bits),
+					  [w0] "n" (layout::w0), [w1] "n" (layout::w1),
+					  [w2] "n" (layout::w2), [w3] "n" (layout::w3),
+					  [w4] "n" (layout::w4), [w5] "n" (layout::w5),
+					  [w6] "n" (layout::w6), [w7] "n" (layout::w7),
+					  [stop] "n" (layout::stop), [gap] "n" (layout::gap)
+					: "cc", "memory");
+			}
+		};
+
+#undef HAST_PRELOAD_PARITY_IMAGE
+#undef HAST_PRELOAD_BITS
+#undef HAST_PRELOAD_BIT
+#undef HAST_PRELOAD_IMAGES
+#undef HAST_PRELOAD_IMAGE
+#undef HAST_PRELOAD_LEVELS
+#undef HAST_ASM_WAIT_END
+#undef HAST_ASM_WAIT
+
+		/** RS-485 driver - asserts the transceiver's driver enable (DE,
+		 *  active high) lead cycles before the start edge and releases it
+		 *  exactly at the end of the stop bit period, see driver::done.
+		 *  Interrupts stay disabled until DE is released, DE stays asserted
+		 *  through a burst. Async mode is not supported
+		  * params
+		  *   de_port, de_ddr, de_pin - DE pin, /RE may be tied to it
+		  *   clock - CPU clock, converts enable_ns to cycles
+		  *   enable_ns - transceiver's driver enable time, ns
+		  *																		*/
+		template<uint8_t port, uint8_t ddr, uint8_t pin, uint8_t de_port,
+				 uint8_t de_ddr, uint8_t de_pin, clock_t clock,
+				 time_t enable_ns = 0, uint8_t space = uart_space_level>
+		struct rs485_driver : driver<port, ddr, pin, space> {
+			using base = driver<port, ddr, pin, space>;
+			static constexpr cycle_t done_cycles = 2; /* cbi				*/
+			/** cycles from DE to the start edge, enable_ns rounded up,
+			 *  at least one												*/
+			static constexpr cycle_t lead = enable_ns > 0 ? (enable_ns *
+				static_cast<time_t>(clock / cpi) + nano - 1) / nano : 1;
+
+			/** initialize port for output, DE pin low						*/
+			__attribute__((always_inline))
+			static inline void init() {
+				base::init();
+				asm volatile ("cbi %0,%2\n sbi %1, %2"
+							 :: "I" (de_port), "I" (de_ddr), "I" (de_pin): "memory");
+			}
+			/** prepare data, disable interrupts, assert DE, send start bit	*/
+			__attribute__((always_inline))
+			static inline void start(uint8_t data) {
+				begin(data);
+				base::resume();
+			}
+			/** prepare data, disable interrupts, assert DE lead cycles
+			 *  before resume sends the start bit							*/
+			__attribute__((always_inline))
+			static inline void begin(uint8_t data) {
+				asm volatile ("mov r18, %0\n mov r21, r18"
+							 ::"r"(data) : "cc", "r18", "r21", "memory");
+				asm volatile ("lsl r18\n eor r21, r18\n ldi r22,%0"
+							 ::"M"(1<<pin): "cc", "r18", "r21", "r22", "memory");
+				enable();
+			}
+			/** fetch the first prepared byte from flash, assert DE lead
+			 *  cycles before resume sends the start bit (send_P)			*/
+			__attribute__((always_inline))
+			static inline void begin_P(const uint8_t*& data) {
+				asm volatile ("lpm r21, %a0+\n ldi r22,%1"
+							 :"+z"(data) :"M"(1<<pin) : "r21", "r22", "memory");
+				enable();
+			}
+			/** send stop bit, interrupts are enabled by done				*/
+			__attribute__((always_inline))
+			static inline volatile void stop(uint8_t) {
+				base::hold();
+			}
+			/** end of burst, interrupts are enabled by done					*/
+			__attribute__((always_inline))
+			static inline volatile void release() {}
+			/** release DE at the end of the stop bit, enable interrupts		*/
+			__attribute__((always_inline))
+			static inline void done() {
+				asm volatile ("cbi %0, %1\n out __SREG__, r19"
+							 :: "I" (de_port), "I" (de_pin) : "r19", "memory");
+			}
+			/** async mode can't assert DE, hast::async does not compile	*/
+			template<bool supported = false>
+			static inline void put(uint8_t) {
+				static_assert(supported, "Async mode is not supported by rs485_driver");
+			}
+		private:
+			/* sbi DE takes effect at its end, out of resume - at its end
+			 * as well, lead - 1 cycles later								*/
+			__attribute__((always_inline))
+			static inline void enable() {
+				if( space == 0 )
+					asm volatile ("in r20, %0\n andi r20,~%1\n in r19, __SREG__\n cli\n sbi %2, %3"
+								 ::"I" (port), "M"(1<<pin), "I" (de_port), "I" (de_pin)
+								 : "cc", "r20", "r19", "memory");
+				else
+					asm volatile ("in r20, %0\n ori  r20,%1\n in r19, __SREG__\n cli\n sbi %2, %3"
+								 ::"I" (port), "M"(1<<pin), "I" (de_port), "I" (de_pin)
+								 : "cc", "r20", "r19", "memory");
+				delay<lead - 1>::cycles();
+			}
+			static_assert(enable_ns >= 0, "DE enable time can't be negative");
+		};
+
+		/** CTS-gated driver - sends a frame only while CTS (active low) is
+		 *  asserted. A single frame or a burst waits for CTS before
+		 *  interrupts are disabled. With burst_wait, a burst also polls
+		 *  CTS right before each start edge, so a frame starts within
+		 *  cts_poll_cycles + 3 after CTS is asserted. That wait has no
+		 *  limit and interrupts stay disabled, hence it is opt-in.
+		 *  Async mode is not supported
+		  * params
+		  *   cts_pinx, cts_pin - CTS input pin
+		  *   burst_wait - wait for CTS between frames of a burst
+		  *																		*/
+		template<uint8_t port, uint8_t ddr, uint8_t pin, uint8_t cts_pinx,
+				 uint8_t cts_pin, bool burst_wait = false,
+				 uint8_t space = uart_space_level>
+		struct cts_driver : driver<port, ddr, pin, space> {
+			using base = driver<port, ddr, pin, space>;
+			static constexpr cycle_t restart_cycles =
+				base::restart_cycles + (burst_wait ? 2 : 0); /* sbic (skips)	*/
+			static constexpr cycle_t restart_P_cycles =
+				base::restart_P_cycles + (burst_wait ? 2 : 0); /* sbic		*/
+			static constexpr cycle_t cts_poll_cycles = 3; /* sbic, rjmp	*/
+
+			/** wait for CTS, prepare data, disable interrupts, send start bit*/
+			__attribute__((always_inline))
+			static inline void start(uint8_t data) {
+				begin(data);
+				base::resume();
+			}
+			/** wait for CTS, prepare data, disable interrupts				*/
+			__attribute__((always_inline))
+			static inline void begin(uint8_t data) {
+				wait();
+				base::begin(data);
+			}
+			/** wait for CTS, fetch the first byte from flash (send_P)		*/
+			__attribute__((always_inline))
+			static inline void begin_P(const uint8_t*& data) {
+				wait();
+				base::begin_P(data);
+			}
+			/** take the fetched byte, with burst_wait wait for CTS,
+			 *  resume sends its start bit									*/
+			template<bool late = false>
+			__attribute__((always_inline))
+			static inline void restart() {
+				if( ! burst_wait )
+					base::template restart<late>();
+				else {
+					if( ! late )
+						asm volatile ("mov r21, r23" ::: "r21", "memory");
+					if( space == 0 )
+						asm volatile ("1: sbic %1, %2\n rjmp 1b\n andi r20,~%0"
+									 ::"M"(1<<pin), "I" (cts_pinx), "I" (cts_pin)
+									 :"cc", "r20", "memory");
+					else
+						asm volatile ("1: sbic %1, %2\n rjmp 1b\n ori  r20,%0"
+									 ::"M"(1<<pin), "I" (cts_pinx), "I" (cts_pin)
+									 :"cc", "r20", "memory");
+				}
+			}
+			/** with burst_wait wait for CTS, start bit image of the fetched
+			 *  byte (send_P)												*/
+			__attribute__((always_inline))
+			static inline void restart_P() {
+				if( ! burst_wait )
+					base::restart_P();
+				else if( space == 0 )
+					asm volatile ("1: sbic %1, %2\n rjmp 1b\n andi r20,~%0"
+								 ::"M"(1<<pin), "I" (cts_pinx), "I" (cts_pin)
+								 : "cc", "r20", "memory");
+				else
+					asm volatile ("1: sbic %1, %2\n rjmp 1b\n ori  r20,%0"
+								 ::"M"(1<<pin), "I" (cts_pinx), "I" (cts_pin)
+								 : "cc", "r20", "memory");
+			}
+			/** async mode does not wait for CTS, hast::async does not
+			 *  compile														*/
+			template<bool supported = false>
+			static inline void put(uint8_t) {
+				static_assert(supported, "Async mode is not supported by cts_driver");
+			}
+		private:
+			__attribute__((always_inline))
+			static inline void wait() {
+				asm volatile ("1: sbic %0, %1\n rjmp 1b"
+							 :: "I" (cts_pinx), "I" (cts_pin) : "memory");
+			}
+		};
+
+		/** PIN input driver - uses sbic/sbis to sample the pin				*/
+		template<uint8_t pinx, uint8_t ddr, uint8_t port, uint8_t pin,
+				 uint8_t space = uart_space_level>
+		struct input {
+			/* NOTE: input disables interrupts on start and enables on stop
+					 or reject
+					 input uses the following sequence to sample a bit:
+						sbic (pinx), (pin)
+						ori  (data), (1<<bit)								*/
+			using mcu = avr;  /* hast::receiver uses mcu::delay				*/
+			static constexpr cycle_t sample_cycles = 2; /* sbic, ori		*/
+			static constexpr cycle_t sample_lead   = 0; /* sbic samples	*/
+			static constexpr cycle_t start_cycles  = 2; /* sbic (skip)		*/
+			static constexpr cycle_t confirm_cycles = 5; /* ldi, sbic, ldi,
+													   tst, breq (not taken)	*/
+			static constexpr cycle_t confirm_lead  = 1; /* after ldi		*/
+			static constexpr cycle_t stop_cycles   = 4; /* ldi,sbic,ldi,out*/
+			static constexpr cycle_t stop_lead     = 1; /* after ldi		*/
+			/** average delay between the start edge and its detection by the
+			 *  3-cycle polling loop, in milicycles							*/
+			static constexpr milicycle_t detect_latency = mili * 3 / 2;
+
+			/** initialize port for input (pull-up on MARK level)			*/
+			__attribute__((always_inline))
+			static inline void init() {
+				if( space == 0 )
+					asm volatile ("cbi %1,%2\n sbi %0, %2"
+								 :: "I" (port), "I" (ddr), "I" (pin): "memory");
+				else
+					asm volatile ("cbi %1,%2\n cbi %0, %2"
+								 :: "I" (port), "I" (ddr), "I" (pin): "memory");
+			}
+
+			/** disable interrupts, clear data, wait for the start bit,
+			 *  returns SREG to pass to stop or reject						*/
+			__attribute__((always_inline))
+			static inline uint8_t start(uint8_t& data) {
+				uint8_t sreg;
+				if( space == 0 )
+					asm volatile ("ldi %0, 0\n in %1, __SREG__\n cli\n"
+								  "sbic %2, %3\n rjmp .-4"
+								 :"=d"(data), "=r"(sreg) :"I" (pinx), "I" (pin) : "memory");
+				else
+					asm volatile ("ldi %0, 0\n in %1, __SREG__\n cli\n"
+								  "sbis %2, %3\n rjmp .-4"
+								 :"=d"(data), "=r"(sreg) :"I" (pinx), "I" (pin) : "memory");
+				return sreg;
+			}
+			/** sample the start bit again, true if it is still SPACE		*/
+			__attribute__((always_inline))
+			static inline bool confirm() {
+				uint8_t held;
+				if( space == 0 )
+					asm volatile ("ldi %0, 1\n sbic %1, %2\n ldi %0, 0"
+								 :"=d"(held) :"I" (pinx), "I" (pin): "memory");
+				else
+					asm volatile ("ldi %0, 1\n sbis %1, %2\n ldi %0, 0"
+								 :"=d"(held) :"I" (pinx), "I" (pin): "memory");
+				return held;
+			}
+			/** drop a glitch, enable interrupts							*/
+			__attribute__((always_inline))
+			static inline bool reject(uint8_t sreg) {
+				asm volatile ("out __SREG__, %0" :: "r"(sreg) : "memory");
+				return false;
+			}
+			/** sample a bit 												*/
+			template<uint8_t bit>
+			__attribute__((always_inline))
+			static inline void sample(uint8_t& data) {
+				if( space == 0 )
+					asm volatile ("sbic %1, %2\n ori %0, %3"
+								 :"+d"(data) :"I" (pinx), "I" (pin), "M"(1<<bit): "memory");
+				else
+					asm volatile ("sbis %1, %2\n ori %0, %3"
+								 :"+d"(data) :"I" (pinx), "I" (pin), "M"(1<<bit): "memory");
+			}
+			/** sample stop bit, enable interrupts							*/
+			__attribute__((always_inline))
+			static inline volatile bool stop(uint8_t sreg) {
+				uint8_t mark;
+				if( space == 0 )
+					asm volatile ("ldi %0, 0\n sbic %1, %2\n ldi %0, 1\n out __SREG__, %3"
+								 :"=&d"(mark) :"I" (pinx), "I" (pin), "r"(sreg): "memory");
+				else
+					asm volatile ("ldi %0, 0\n sbis %1, %2\n ldi %0, 1\n out __SREG__, %3"
+								 :"=&d"(mark) :"I" (pinx), "I" (pin), "r"(sreg): "memory");
+				return mark;
+			}
+		private:
+			static_assert(space==0 || space==1, "Invalid space value. Valid values are: 0, 1");
+		};
+
+		/** Multi-channel PORT driver - drives all pins in mask with one out
+		 *  per bit slot. Port images for all slots are computed before cli
+		 *  and loaded with ld X+/Y+/Z+, so a bit costs the same 3 cycles	*/
+		template<uint8_t port, uint8_t ddr, uint8_t mask, uint8_t space = uart_space_level>
+		struct parallel_driver {
+			/* NOTE: driver disables interrupts on start and enables on stop
+					 driver uses the following sequence to send a bit:
+						ld   r20, (slot)+
+						out  (port), r20									*/
+			using mcu = avr;  /* hast::trasmitter uses mcu::delay			*/
+			static constexpr cycle_t send_cycles  = 3; /* ld, out			*/
+			static constexpr cycle_t start_cycles = 0; /* nothing after out */
+			static constexpr cycle_t stop_cycles  = 3; /* ld, out			*/
+			static constexpr uint8_t channels =
+				((mask>>0)&1) + ((mask>>1)&1) + ((mask>>2)&1) + ((mask>>3)&1) +
+				((mask>>4)&1) + ((mask>>5)&1) + ((mask>>6)&1) + ((mask>>7)&1);
+
+			/** initialize port for output									*/
+			__attribute__((always_inline))
+			static inline void init() {
+				if( space == 0 )
+					asm volatile ("in r18, %0\n ori r18, %2\n out %0, r18\n"
+								  "in r18, %1\n ori r18, %2\n out %1, r18"
+								 :: "I" (port), "I" (ddr), "M" (mask): "cc", "r18", "memory");
+				else
+					asm volatile ("in r18, %0\n andi r18, ~%2\n out %0, r18\n"
+								  "in r18, %1\n ori r18, %2\n out %1, r18"
+								 :: "I" (port), "I" (ddr), "M" (mask): "cc", "r18", "memory");
+			}
+
+			/** transpose channel bytes into port images for all bit slots:
+			 *  image[0] - start bit, image[1..8] - data bits, image[9] - stop
+			 *  Runs with interrupts enabled								*/
+			static inline void prepare(uint8_t* image, const uint8_t* data) {
+				uint8_t base;
+				asm volatile ("in %0, %1" : "=r"(base) : "I" (port));
+				base &= ~mask;
+				const uint8_t mark  = space ? 0 : mask;
+				for(uint8_t bit = 0; bit < 8; ++bit) {
+					uint8_t plane = 0;
+					const uint8_t* channel = data;
+					for(uint8_t pin = 0; pin < 8; ++pin) {
+						if( (mask & (1<<pin)) == 0 ) continue;
+						if( (*channel++ >> bit) & 1 ) plane |= (1<<pin);
+					}
+					image[bit+1] = base | (space ? (mask & ~plane) : plane);
+				}
+				image[0] = base | (mark ^ mask);
+				image[9] = base | mark;
+			}
+			/** disable interrupts, send start bit 							*/
+			__attribute__((always_inline))
+			static inline void start(const uint8_t*& slot) {
+				asm volatile ("in r19, __SREG__\n cli\n ld r20, %a0+\n out %1, r20"
+							 :"+e"(slot) : "I" (port) : "r19", "r20", "memory");
+			}
+			/** send a bit on all channels									*/
+			__attribute__((always_inline))
+			static inline void send(const uint8_t*& slot) {
+				asm volatile ("ld r20, %a0+\n out %1, r20"
+							 :"+e"(slot) : "I" (port) : "r20", "memory");
+			}
+			/** send stop bit, enable interrupts							*/
+			__attribute__((always_inline))
+			static inline volatile void stop(const uint8_t*& slot) {
+				asm volatile ("ld r20, %a0+\n out %1, r20\n out __SREG__, r19"
+							 :"+e"(slot) : "I" (port) : "r19", "r20", "memory");
+			}
+		private:
+			static_assert(space==0 || space==1, "Invalid space value. Valid values are: 0, 1");
+			static_assert(mask != 0, "Empty pin mask");
+		};
+
+		/** fixed cost steps of hast::packet, run as send<work> slices in
+		 *  the bit padding. Each loads the cursor from memory, works in
+		 *  r24..r27, r30, r31 and stores it back. A step past the end of
+		 *  the payload reads the byte at end, which is harmless on AVR, and
+		 *  changes nothing													*/
+		template<packet_cursor& c>
+		struct packet_steps {
+			static constexpr cycle_t crc_cycles = 55;
+			static constexpr cycle_t scan_cycles = 42;
+
+			/** CRC-16/CCITT of the byte at crc_at, avr-libc's
+			 *  _crc_xmodem_update, then advance crc_at					*/
+			__attribute__((always_inline))
+			static inline void crc() {
+				asm volatile (
+					"lds r24, %[crc]\n lds r25, %[crc]+1\n"
+					"lds r26, %[at]\n lds r27, %[at]+1\n ld r31, X\n"
+					"eor r25, r31\n mov r0, r25\n swap r0\n"
+					"mov r31, r0\n andi r31, 0x0f\n eor r31, r25\n"
+					"mov r30, r25\n eor r30, r0\n lsl r30\n andi r30, 0xe0\n"
+					"eor r31, r30\n" /* r31 - CRC low						*/
+					"mov r30, r0\n eor r30, r25\n andi r30, 0xf0\n lsr r30\n"
+					"mov r0, r25\n lsl r0\n rol r30\n"
+					"lsr r25\n lsr r25\n lsr r25\n andi r25, 0x1f\n"
+					"eor r25, r30\n eor r25, r24\n" /* r25 - CRC high		*/
+					"lds r30, %[end]\n lds r24, %[end]+1\n"
+					"cp r26, r30\n cpc r27, r24\n in r0, __SREG__\n adiw r26, 1\n"
+					"sbrs r0, 1\n sts %[crc], r31\n sbrs r0, 1\n sts %[crc]+1, r25\n"
+					"sbrs r0, 1\n sts %[at], r26\n sbrs r0, 1\n sts %[at]+1, r27"
+					:: [crc] "i" (&c.crc), [at] "i" (&c.crc_at), [end] "i" (&c.end)
+					: "cc", "r24", "r25", "r26", "r27", "r30", "r31", "memory");
+			}
+			/** COBS scan of the byte at scan_at while open: a zero closes
+			 *  the block, a non-zero byte extends it, the 254th closes it.
+			 *  At end the block stays open, C scans on into the CRC		*/
+			__attribute__((always_inline))
+			static inline void scan() {
+				asm volatile (
+					"lds r26, %[at]\n lds r27, %[at]+1\n"
+					"lds r24, %[end]\n lds r25, %[end]+1\n"
+					"lds r30, %[run]\n lds r31, %[open]\n"
+					"cp r26, r24\n cpc r27, r25\n in r24, __SREG__\n ld r25, X\n"
+					"mov r0, r31\n sbrc r24, 1\n clr r0\n" /* r0 - active	*/
+					"mov r24, r0\n cpse r25, r1\n clr r24\n" /* r24 - zero	*/
+					"cpse r25, r1\n mov r25, r0\n" /* r25 - extends		*/
+					"cpse r24, r1\n clr r31\n"
+					"add r26, r25\n adc r27, r1\n add r30, r25\n"
+					"cpi r30, 254\n in r25, __SREG__\n sbrc r25, 1\n clr r31\n"
+					"sts %[at], r26\n sts %[at]+1, r27\n"
+					"sts %[run], r30\n sts %[open], r31"
+					:: [at] "i" (&c.scan_at), [end] "i" (&c.end),
+					   [run] "i" (&c.run), [open] "i" (&c.open)
+					: "cc", "r24", "r25", "r26", "r27", "r30", "r31", "memory");
+			}
+		};
+
+		/** shortcut for hast::transmitter with avr::driver							*/
+		template<clock_t clock, clock_t baudrate, uint8_t port, uint8_t pin, 
+				 uint8_t space = uart_space_level, stopbits sb=stopbits::one>
+		struct transmitter;
+
+		/** shortcut for hast::receiver with avr::input								*/
+		template<clock_t clock, clock_t baudrate, uint8_t port, uint8_t pin,
+				 uint8_t space = uart_space_level>
+		struct receiver;
+
+		/** 8-bit Timer/Counter0 in normal mode, compare unit A, for
+		 *  hast::async. prescaler: 1, 8, 64, 256, 1024					*/
+		template<uint16_t prescale>
+		struct timer0;
+
+		/** 16-bit Timer/Counter1 in normal mode, compare unit A (ATmega)	*/
+		template<uint16_t prescale>
+		struct timer1;
+	};
+
+	/* Implementation of delay injectors
+	   credits to http://www.bretmulvey.com/avrdelay.html							*/
+	template<> inline volatile void avr::delay< 0>::cycles() {}
+	template<> inline volatile void avr::delay< 1>::cycles() { asm volatile("nop"); }
+	template<> inline volatile void avr::delay< 2>::cycles() { asm volatile("rjmp ."); }
+	template<> inline volatile void avr::delay< 3>::cycles() { asm volatile("lpm"); }
+	template<> inline volatile void avr::delay< 4>::cycles() { delay<2>::cycles(); delay<2>::cycles(); }
+	template<> inline volatile void avr::delay< 5>::cycles() { delay<3>::cycles(); delay<2>::cycles(); }
+	template<> inline volatile void avr::delay< 6>::cycles() { delay<3>::cycles(); delay<3>::cycles(); }
+	template<> inline volatile void avr::delay< 7>::cycles() { delay<6>::cycles(); delay<1>::cycles(); }
+	template<> inline volatile void avr::delay< 8>::cycles() { delay<6>::cycles(); delay<2>::cycles(); }
+	template<> inline volatile void avr::delay< 9>::cycles() { delay<6>::cycles(); delay<3>::cycles(); }
+	template<> inline volatile void avr::delay<10>::cycles() { delay<9>::cycles(); delay<1>::cycles(); }
+	template<> inline volatile void avr::delay<11>::cycles() { delay<9>::cycles(); delay<2>::cycles(); }
+		
+	/** Short loop delay (period/3 cycles)											*/
+	template<cycle_t period_ic>
+	struct avr::loop<period_ic, false> {
+		static constexpr cycle_t count = period_ic/3;
+		static_warn(count <= 255, "Loop is too long");
+		__attribute__((always_inline)) 
+		static inline volatile void cycles() {
+			asm volatile ("ldi  r18, %0\n dec  r18\n brne .-4"
+						::"M"(count):"cc","r18");
+			delay<period_ic % 3>::cycles();			
+		}
+	};
+	
+	/** Long loop delay (period/6 cycles)											*/
+	template<cycle_t period_ic>
+	struct avr::loop<period_ic, true> {
+		static constexpr cycle_t count = period_ic/6;
+		static_warn(count <= 255, "Loop is too long");
+		__attribute__((always_inline)) 
+		static inline volatile void cycles() {
+			asm volatile ("ldi  r18, %0\n lpm; \n dec  r18\n brne .-5"
+						::"M" (count):"cc","r18");
+			delay<period_ic % 6>::cycles();			
+		}
+	};
+
+/* Use of PORTx is not allowed in templates, ADDR_OF provides a workaround		*/
+#ifdef _SFR_IO8
+#define ADDR_OF(R) ((&R)-&_SFR_IO8(0))
+
+#if defined(PORTA0) || defined(PORTA1) || defined(PORTA2) || defined(PORTA3) || \
+	defined(PORTA4) || defined(PORTA5) || defined(PORTA6) || defined(PORTA7)
+	template<clock_t clock, clock_t baudrate, uint8_t pin, uint8_t space, stopbits sb>
+	struct avr::transmitter<clock, baudrate, ADDR_OF(PORTA), pin, space, sb> :
+		hast::transmitter<clock, baudrate, driver<ADDR_OF(PORTA), 
+		ADDR_OF(DDRA), pin, space>, sb> {};
+	template<clock_t clock, clock_t baudrate, uint8_t pin, uint8_t space>
+	struct avr::receiver<clock, baudrate, ADDR_OF(PORTA), pin, space> :
+		hast::receiver<clock, baudrate, input<ADDR_OF(PINA),
+		ADDR_OF(DDRA), ADDR_OF(PORTA), pin, space>> {};
+#endif
 
 #if defined(PORTB0) || defined(PORTB1) || defined(PORTB2) || defined(PORTB3) || \
 	defined(PORTB4) || defined(PORTB5) || defined(PORTB6) || defined(PORTB7) 
@@ -353,6 +3696,10 @@ namespace hast {
 	struct avr::transmitter<clock, baudrate, ADDR_OF(PORTB), pin, space, sb> :
 		hast::transmitter<clock, baudrate, driver<ADDR_OF(PORTB), 
 		ADDR_OF(DDRB), pin, space>, sb> {};
+	template<clock_t clock, clock_t baudrate, uint8_t pin, uint8_t space>
+	struct avr::receiver<clock, baudrate, ADDR_OF(PORTB), pin, space> :
+		hast::receiver<clock, baudrate, input<ADDR_OF(PINB),
+		ADDR_OF(DDRB), ADDR_OF(PORTB), pin, space>> {};
 #endif
 
 #if defined(PORTC0) || defined(PORTC1) || defined(PORTC2) || defined(PORTC3) || \
@@ -361,6 +3708,10 @@ namespace hast {
 	struct avr::transmitter<clock, baudrate, ADDR_OF(PORTC), pin, space, sb> :
 		hast::transmitter<clock, baudrate, driver<ADDR_OF(PORTC), 
 		ADDR_OF(DDRC), pin, space>, sb> {};
+	template<clock_t clock, clock_t baudrate, uint8_t pin, uint8_t space>
+	struct avr::receiver<clock, baudrate, ADDR_OF(PORTC), pin, space> :
+		hast::receiver<clock, baudrate, input<ADDR_OF(PINC),
+		ADDR_OF(DDRC), ADDR_OF(PORTC), pin, space>> {};
 #endif
 
 #if defined(PORTD0) || defined(PORTD1) || defined(PORTD2) || defined(PORTD3) || \
@@ -369,6 +3720,139 @@ namespace hast {
 	struct avr::transmitter<clock, baudrate, ADDR_OF(PORTD), pin, space, sb> :
 		hast::transmitter<clock, baudrate, driver<ADDR_OF(PORTD), 
 		ADDR_OF(DDRD), pin, space>, sb> {};
+	template<clock_t clock, clock_t baudrate, uint8_t pin, uint8_t space>
+	struct avr::receiver<clock, baudrate, ADDR_OF(PORTD), pin, space> :
+		hast::receiver<clock, baudrate, input<ADDR_OF(PIND),
+		ADDR_OF(DDRD), ADDR_OF(PORTD), pin, space>> {};
+#endif
+#endif
+
+#ifdef __AVR__
+	/* clock select bits for prescaler of timer 0 and ATmega timer 1		*/
+	inline constexpr uint8_t avr_clock_select(uint16_t prescale) {
+		return prescale == 1 ? 1 : prescale == 8 ? 2 : prescale == 64 ? 3 :
+			   prescale == 256 ? 4 : prescale == 1024 ? 5 : 0;
+	}
+
+#if defined(TIMSK0)
+#	define HAST_TIMSK0 TIMSK0
+#	define HAST_TIFR0  TIFR0
+#else
+#	define HAST_TIMSK0 TIMSK
+#	define HAST_TIFR0  TIFR
+#endif
+
+	template<uint16_t prescale>
+	struct avr::timer0 {
+		using count_t = uint8_t;
+		static constexpr uint16_t prescaler = prescale;
+		static constexpr count_t max_count = 0xFF;
+		static inline void init() {
+			TCCR0A = 0;
+			TCCR0B = avr_clock_select(prescale);
+		}
+		/** cycles from reading the count to clearing the compare flag	*/
+		static constexpr cycle_t schedule_cycles = 5; /* in, subi, out,
+												   ldi, out				*/
+		/** first compare in ticks from now, enable interrupt			*/
+		static inline void schedule(count_t ticks) {
+			OCR0A = TCNT0 + ticks;
+			HAST_TIFR0 = 1 << OCF0A;
+			HAST_TIMSK0 |= 1 << OCIE0A;
+		}
+		/** next compare in ticks from the previous one					*/
+		static inline void advance(count_t ticks) {
+			OCR0A += ticks;
+		}
+		static inline void disable() {
+			HAST_TIMSK0 &= ~(1 << OCIE0A);
+		}
+		/* interrupt windows, see transmitter::windows					*/
+		static constexpr cycle_t read_cycles = 1; /* in					*/
+		static constexpr cycle_t poll_cycles = 4; /* in, sub, brmi		*/
+		static constexpr cycle_t window_cycles = 8; /* out, nop, cli, mov,
+											subi, in, sub, brmi			*/
+		/** read the count, kept in r25 for the windows					*/
+		__attribute__((always_inline))
+		static inline uint8_t capture() {
+			register uint8_t count asm("r25");
+			asm volatile ("in %0, %1" : "=r" (count) : "I" (_SFR_IO_ADDR(TCNT0)) : "memory");
+			return count;
+		}
+		/** restore SREG, let pending interrupts run, then poll until
+		 *  the count reaches origin + target							*/
+		template<uint8_t target>
+		__attribute__((always_inline))
+		static inline void window(uint8_t origin) {
+			register uint8_t count asm("r25") = origin;
+			asm volatile ("out __SREG__, r19\n nop\n cli\n mov r18, %1\n subi r18, %2\n"
+						  "1: in r24, %0\n sub r24, r18\n brmi 1b"
+						 :: "I" (_SFR_IO_ADDR(TCNT0)), "r" (count), "M" ((0x100 - target) & 0xFF)
+						 : "cc", "r18", "r24", "memory");
+		}
+		static_assert(avr_clock_select(prescale) != 0,
+			"Invalid prescaler value. Valid values are: 1, 8, 64, 256, 1024");
+	};
+
+#if defined(OCR1AH) && defined(TCCR1B)
+#if defined(TIMSK1)
+#	define HAST_TIMSK1 TIMSK1
+#	define HAST_TIFR1  TIFR1
+#else
+#	define HAST_TIMSK1 TIMSK
+#	define HAST_TIFR1  TIFR
+#endif
+	template<uint16_t prescale>
+	struct avr::timer1 {
+		using count_t = uint16_t;
+		static constexpr uint16_t prescaler = prescale;
+		static constexpr count_t max_count = 0xFFFF;
+		static inline void init() {
+			TCCR1A = 0;
+			TCCR1B = avr_clock_select(prescale);
+		}
+		/** cycles from reading the count to clearing the compare flag	*/
+		static constexpr cycle_t schedule_cycles = 12; /* lds, lds, subi,
+											sbci, sts, sts, ldi, out	*/
+		/** first compare in ticks from now, enable interrupt			*/
+		static inline void schedule(count_t ticks) {
+			OCR1A = TCNT1 + ticks;
+			HAST_TIFR1 = 1 << OCF1A;
+			HAST_TIMSK1 |= 1 << OCIE1A;
+		}
+		/** next compare in ticks from the previous one					*/
+		static inline void advance(count_t ticks) {
+			OCR1A += ticks;
+		}
+		static inline void disable() {
+			HAST_TIMSK1 &= ~(1 << OCIE1A);
+		}
+		/* interrupt windows, low byte of the count						*/
+		static constexpr cycle_t read_cycles = 2; /* lds				*/
+		static constexpr cycle_t poll_cycles = 5; /* lds, sub, brmi		*/
+		static constexpr cycle_t window_cycles = 9; /* out, nop, cli, mov,
+											subi, lds, sub, brmi		*/
+		/** read the count, kept in r25 for the windows					*/
+		__attribute__((always_inline))
+		static inline uint8_t capture() {
+			register uint8_t count asm("r25");
+			asm volatile ("lds %0, %1" : "=r" (count) : "n" (_SFR_MEM_ADDR(TCNT1L)) : "memory");
+			return count;
+		}
+		/** restore SREG, let pending interrupts run, then poll until
+		 *  the count reaches origin + target							*/
+		template<uint8_t target>
+		__attribute__((always_inline))
+		static inline void window(uint8_t origin) {
+			register uint8_t count asm("r25") = origin;
+			asm volatile ("out __SREG__, r19\n nop\n cli\n mov r18, %1\n subi r18, %2\n"
+						  "1: lds r24, %0\n sub r24, r18\n brmi 1b"
+						 :: "n" (_SFR_MEM_ADDR(TCNT1L)), "r" (count), "M" ((0x100 - target) & 0xFF)
+						 : "cc", "r18", "r24", "memory");
+		}
+		static_assert(avr_clock_select(prescale) != 0,
+			"Invalid prescaler value. Valid values are: 1, 8, 64, 256, 1024");
+	};
 #endif
 #endif
 	
@@ -0,0 +1,888 @@
+/* HAST - Software Defined High-speed Asynchronous Serial Transmitter
+ * hast_sim.hpp - host-side cycle-accurate simulation of HAST drivers
+ *
+ * Copyright (C) 2018 Eugene Hutorny <eugene@hutorny.in.ua>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ * https://opensource.org/licenses/MIT
+ */
+
+#pragma once
+#include <cstdio>
+#include <vector>
+#include "hast.hpp"
+
+namespace hast {
+
+	/************************************************************************/
+	/** Simulated MCU, a drop-in replacement for avr.
+	 *  Delays and driver sequences advance a virtual cycle counter by the
+	 *  same amount of cycles AVR code would take, line edges are recorded
+	 *  in a trace for further analysis									*/
+	struct sim {
+		static constexpr cycle_t cpi = avr::cpi;
+		static constexpr cycle_t branch_cycles = avr::branch_cycles;
+		static constexpr cycle_t isr_entry_cycles = avr::isr_entry_cycles;
+		static constexpr cycle_t isr_jitter_cycles = avr::isr_jitter_cycles;
+
+		static inline uint8_t disable_interrupts() { return 0; }
+		static inline void restore_interrupts(uint8_t) {}
+
+		/** line level change at the given cycle						*/
+		struct edge {
+			cycle_t at;
+			uint8_t level;
+		};
+		using trace_t = std::vector<edge>;
+
+		/** call a routine taken from a table, icall					*/
+		static constexpr cycle_t call_cycles = avr::call_cycles;
+		static inline void call(void (*routine)(uint16_t), uint16_t arg) {
+			advance(call_cycles);
+			routine(arg);
+		}
+
+		/** tables are in RAM on the host								*/
+		template<typename T>
+		static inline T flash(const T* p) {
+			return *p;
+		}
+
+		/** virtual cycle counter										*/
+		static inline cycle_t& now() {
+			static cycle_t counter = 0;
+			return counter;
+		}
+		/** recorded line edges											*/
+		static inline trace_t& trace() {
+			static trace_t edges;
+			return edges;
+		}
+		/** current line level											*/
+		static inline uint8_t& line() {
+			static uint8_t level = 1;
+			return level;
+		}
+		/** reset counter and trace, set idle line level				*/
+		static inline void reset(uint8_t idle = 1) {
+			now() = 0;
+			trace().clear();
+			line() = idle;
+		}
+		static inline void advance(cycle_t cycles) {
+			now() += cycles;
+		}
+		/** drive the line, record an edge if the level changes			*/
+		static inline void drive(uint8_t level) {
+			if( level != line() )
+				trace().push_back(edge{now(), level});
+			line() = level;
+		}
+
+		/** interleaved mode, registers as on AVR						*/
+		static constexpr uint8_t lanes = avr::lanes;
+		static constexpr uint8_t lane_data(uint8_t c) {
+			return avr::lane_data(c);
+		}
+		static constexpr uint8_t lane_image(uint8_t c) {
+			return avr::lane_image(c);
+		}
+		/** register file												*/
+		static inline uint8_t& file(uint8_t reg) {
+			static uint8_t regs[32];
+			return regs[reg & 31];
+		}
+		/** I/O ports, out-addressable									*/
+		static inline uint8_t& io(uint8_t port) {
+			static uint8_t ports[64];
+			return ports[port & 63];
+		}
+		/** recorded edges of a port pin									*/
+		static inline trace_t& pin_trace(uint8_t port, uint8_t pin) {
+			static trace_t traces[64 * 8];
+			return traces[(port & 63) * 8 + (pin & 7)];
+		}
+		/** write the port, record edges of the pins that change			*/
+		static inline void write(uint8_t port, uint8_t value) {
+			for(uint8_t pin = 0; pin < 8; ++pin)
+				if( ((io(port) ^ value) >> pin) & 1 )
+					pin_trace(port, pin).push_back(edge{now(), static_cast<uint8_t>((value >> pin) & 1)});
+			io(port) = value;
+		}
+
+		/** program memory of delay<period> on AVR, words				*/
+		static constexpr uint8_t delay_words(cycle_t period) {
+			return avr::delay_words(period);
+		}
+
+		/** delay injector, same limits as avr::delay					*/
+		template<cycle_t period_ic>
+		struct delay {
+			static constexpr cycle_t max = avr::delay<period_ic>::max;
+			static constexpr cycle_t period = period_ic;
+			static inline void cycles() {
+				advance(period_ic);
+			}
+		};
+
+		/** driver with timing of the given AVR driver, sends the same
+		 *  prepared toggles (data ^ data<<1) as the AVR code does
+		  * params
+		  *   avr_driver	- AVR driver to take timing from
+		  *   lead		- cycles from start() call to the start edge
+		  *   space		- SPACE level								*/
+		template<typename avr_driver, cycle_t lead, uint8_t space>
+		struct model {
+			using mcu = sim;
+			static constexpr cycle_t send_cycles    = avr_driver::send_cycles;
+			static constexpr cycle_t start_cycles   = avr_driver::start_cycles;
+			static constexpr cycle_t stop_cycles    = avr_driver::stop_cycles;
+			static constexpr cycle_t restart_cycles = avr_driver::restart_cycles;
+			static constexpr cycle_t fetch_cycles = avr_driver::fetch_cycles;
+			static constexpr cycle_t take_cycles = avr_driver::take_cycles;
+			static constexpr cycle_t loop_setup_cycles = avr_driver::loop_setup_cycles;
+			static constexpr cycle_t loop_cycles    = avr_driver::loop_cycles;
+			static constexpr cycle_t wave_level_cycles = avr_driver::wave_level_cycles;
+			static constexpr cycle_t wave_bit_cycles = avr_driver::wave_bit_cycles;
+			static constexpr cycle_t wave_next_cycles = avr_driver::wave_next_cycles;
+			static constexpr uint8_t mark = space ? 0 : 1;
+			static constexpr bool whole_frame = false;
+			template<uint8_t n, bool odd>
+			static constexpr cycle_t parity_cycles() {
+				return avr_driver::template parity_cycles<n, odd>();
+			}
+
+			static inline void init() {
+				reset(mark);
+			}
+			static inline void start(uint8_t data) {
+				begin(data);
+				resume();
+			}
+			static inline void begin(uint8_t data) {
+				reg().r21 = data ^ (data << 1);
+				advance(lead - 1);
+			}
+			/** out of the start edge										*/
+			static inline void resume() {
+				advance(1);
+				drive(reg().r20 = !mark);
+			}
+			template<uint8_t bit>
+			static inline void send(uint8_t) {
+				advance(send_cycles);
+				if( bit < 8 ? (reg().r21 >> (bit & 7)) & 1 : reg().r23 & 1 )
+					reg().r20 ^= 1;
+				drive(reg().r20);
+			}
+			/** bit loop, the last brne is not taken						*/
+			template<uint8_t n, typename pad>
+			static inline void loop() {
+				advance(loop_setup_cycles);
+				for(uint8_t i = 0; i < n; ++i) {
+					advance(send_cycles);
+					if( reg().r21 & 1 )
+						reg().r20 ^= 1;
+					drive(reg().r20);
+					pad::cycles();
+					advance(i + 1 < n ? loop_cycles : loop_cycles - 1);
+					reg().r21 = (reg().r21 >> 1) | ((reg().r23 & 1) << 7);
+					reg().r23 >>= 1;
+				}
+			}
+			/** timer capture and windows (interrupt windows), in of the
+			 *  port image after a window; ISRs leave the line alone		*/
+			static constexpr cycle_t reload_cycles = avr_driver::reload_cycles;
+			template<typename timer>
+			static inline uint8_t capture() {
+				return timer::capture();
+			}
+			template<typename timer, uint8_t target>
+			static inline void window(uint8_t origin) {
+				timer::template window<target>(origin);
+				advance(reload_cycles);
+				reg().r20 = line();
+			}
+			/** waveform mode, levels are electrical						*/
+			template<uint8_t level>
+			static inline void wave_init() {
+				reset(level);
+				reg().r20 = level;
+			}
+			/** before cli, not timed										*/
+			static inline void wave_begin(const uint8_t*& data) {
+				reg().r21 = *data++;
+			}
+			template<uint8_t level>
+			static inline void wave_level() {
+				advance(wave_level_cycles);
+				drive(reg().r20 = level);
+			}
+			template<uint8_t bit, bool invert>
+			static inline void wave_bit() {
+				advance(wave_bit_cycles);
+				drive(reg().r20 = ((reg().r21 >> bit) & 1) ^ invert);
+			}
+			/** loop count and branch, ld, mov, com						*/
+			static inline void wave_next(const uint8_t*& data) {
+				advance(wave_next_cycles);
+				reg().r21 = *data++;
+			}
+			/** sbiw, breq taken after the last byte, out SREG				*/
+			static inline void wave_end() {
+				advance(4 + 1);
+			}
+			/** interleaved mode, each lane keeps its own pin trace		*/
+			static constexpr cycle_t lane_level_cycles = avr_driver::lane_level_cycles;
+			static constexpr cycle_t lane_bit_cycles = avr_driver::lane_bit_cycles;
+			static constexpr cycle_t lane_write_cycles = avr_driver::lane_write_cycles;
+			static constexpr uint8_t lane_port = avr_driver::lane_port;
+			static inline void lane_init() {
+				init();
+				pin_trace(lane_port, avr_driver::lane_pin).clear();
+				lane_set(io(lane_port), mark);
+			}
+			/** before cli, not timed										*/
+			template<uint8_t reg>
+			static inline void lane_load(uint8_t data) {
+				file(reg) = space ? ~data : data;
+			}
+			template<uint8_t image>
+			static inline void lane_read() {
+				file(image) = io(lane_port);
+			}
+			template<uint8_t image, uint8_t level>
+			static inline void lane_level() {
+				advance(lane_level_cycles);
+				lane_set(file(image), level ? mark : !mark);
+			}
+			template<uint8_t data, uint8_t bit, uint8_t image>
+			static inline void lane_bit() {
+				advance(lane_bit_cycles);
+				lane_set(file(image), (file(data) >> bit) & 1);
+			}
+			template<uint8_t image>
+			static inline void lane_write() {
+				advance(lane_write_cycles);
+				write(lane_port, file(image));
+			}
+			/** sbi/cbi (async mode)										*/
+			static inline void put(uint8_t level) {
+				drive(reg().r20 = level ? mark : !mark);
+			}
+			/** mov r23 - before start										*/
+			static inline void extend(uint8_t toggle) {
+				reg().r23 = toggle;
+			}
+			/** parity of n-1 bits into the toggle of bit n				*/
+			template<uint8_t n, bool odd>
+			static inline void parity(uint8_t bits) {
+				uint8_t x = bits & ((1 << (n-1)) - 1);
+				x ^= x >> 4;
+				x ^= x >> 2;
+				x ^= x >> 1;
+				reg().r23 = (x ^ odd) & 1;
+				if( n < 8 )
+					reg().r21 = (reg().r21 & ~(1 << (n & 7))) | (reg().r23 << (n & 7));
+				advance(parity_cycles<n, odd>());
+			}
+			static inline void stop(uint8_t) {
+				hold();
+				release();
+			}
+			static inline void hold() {
+				advance(stop_cycles);
+				drive(reg().r20 = mark);
+			}
+			/** ld, prepare into r23, late into r21 (burst mode)			*/
+			template<bool late = false>
+			static inline void fetch(const uint8_t*& data) {
+				const uint8_t value = *data++;
+				(late ? reg().r21 : reg().r23) = value ^ (value << 1);
+				advance(fetch_cycles);
+			}
+			/** burst loop branch, then mov, resume takes the out			*/
+			template<bool late = false>
+			static inline void restart() {
+				if( ! late )
+					reg().r21 = reg().r23;
+				advance(branch_cycles + restart_cycles - 1 - (late ? take_cycles : 0));
+			}
+			static inline void release() {
+				advance(1);
+			}
+			/** end of the stop bit period								*/
+			static constexpr cycle_t done_cycles = avr_driver::done_cycles;
+			static inline void done() {
+				advance(done_cycles);
+			}
+			/** send_P, flash is RAM on the host							*/
+			static constexpr cycle_t fetch_P_cycles = avr_driver::fetch_P_cycles;
+			static constexpr cycle_t restart_P_cycles = avr_driver::restart_P_cycles;
+			static constexpr uint8_t prepare(uint8_t data) {
+				return avr_driver::prepare(data);
+			}
+			/** lpm, ldi, in, andi, in, cli								*/
+			static inline void begin_P(const uint8_t*& data) {
+				reg().r21 = *data++;
+				advance(fetch_P_cycles + 5);
+			}
+			/** burst loop branch, then lpm								*/
+			static inline void fetch_P(const uint8_t*& data) {
+				reg().r21 = *data++;
+				advance(branch_cycles + fetch_P_cycles);
+			}
+			/** andi/ori, resume takes the out								*/
+			static inline void restart_P() {
+				advance(restart_P_cycles - 1);
+			}
+		private:
+			static inline void lane_set(uint8_t& image, uint8_t level) {
+				image = (image & ~(1 << avr_driver::lane_pin)) | (level << avr_driver::lane_pin);
+			}
+			/* registers the AVR driver keeps its state in					*/
+			struct registers {
+				uint8_t r20;	/* port state, here - line level			*/
+				uint8_t r21;	/* prepared data							*/
+				uint8_t r23;	/* prepared ninth bit						*/
+			};
+			static inline registers& reg() {
+				static registers r = { 1, 0, 0 };
+				return r;
+			}
+		};
+
+		/** avr::driver, mov, mov, lsl, eor, ldi, in, andi, in, cli, out	*/
+		template<uint8_t port, uint8_t ddr, uint8_t pin, uint8_t space = uart_space_level>
+		struct driver : model<avr::driver<port, ddr, pin, space>, 10, space> {};
+
+		/** avr::toggle_driver, mov, mov, lsl, eor, ldi, in, cli, out		*/
+		template<uint8_t pinx, uint8_t ddr, uint8_t port, uint8_t pin,
+				 uint8_t space = uart_space_level>
+		struct toggle_driver :
+			model<avr::toggle_driver<pinx, ddr, port, pin, space>, 8, space> {};
+
+		/** avr::preload_driver, levels of the bit slots are kept as
+		 *  images, the way the AVR code keeps port images				*/
+		template<uint8_t port, uint8_t ddr, uint8_t pin, uint8_t space = uart_space_level>
+		struct preload_driver :
+			model<avr::preload_driver<port, ddr, pin, space>, 0, space> {
+			using avr_driver = avr::preload_driver<port, ddr, pin, space>;
+			using base = model<avr_driver, 0, space>;
+			static constexpr bool whole_frame = true;
+			/** in, ori, mov, andi, images, in, cli, out					*/
+			template<typename layout>
+			static inline void frame(uint8_t data) {
+				uint8_t image[8];
+				load<layout>(image, data);
+				advance(4 + 3 * layout::bits + 3);
+				drive(!base::mark);
+				if( layout::parity ) {
+					uint8_t x = data & ((1 << layout::parity) - 1);
+					x ^= x >> 4;
+					x ^= x >> 2;
+					x ^= x >> 1;
+					image[layout::parity & 7] =
+						((x ^ layout::odd) & 1) ? base::mark : !base::mark;
+					advance(avr_driver::template
+						parity_cycles<layout::parity, layout::odd>());
+				}
+				bits<layout>(image);
+				advance(1); /* out SREG									*/
+			}
+			/** in, ori, mov, andi, ld, images, in, cli, then per frame:
+			 *  out, bits, dec, breq, gap, ld, images, rjmp				*/
+			template<typename layout>
+			static inline void burst(const uint8_t* data, uint8_t n) {
+				uint8_t image[8];
+				load<layout>(image, *data++);
+				advance(4 + 2 + 3 * layout::bits + 3);
+				for(;;) {
+					drive(!base::mark);
+					bits<layout>(image);
+					if( --n == 0 ) break;
+					load<layout>(image, *data++);
+					advance(branch_cycles + layout::gap + avr_driver::restart_cycles);
+				}
+				advance(3 + 1); /* dec, breq, out SREG					*/
+			}
+		private:
+			template<typename layout>
+			static inline void load(uint8_t* image, uint8_t data) {
+				for(uint8_t k = 0; k < layout::bits; ++k)
+					image[k] = ((data >> k) & 1) ? base::mark : !base::mark;
+			}
+			/** paddings, data edges and the stop edge					*/
+			template<typename layout>
+			static inline void bits(const uint8_t* image) {
+				const cycle_t wait[8] = { layout::w0, layout::w1, layout::w2,
+					layout::w3, layout::w4, layout::w5, layout::w6, layout::w7 };
+				for(uint8_t k = 0; k < layout::bits; ++k) {
+					advance(wait[k] + avr_driver::send_cycles);
+					drive(image[k]);
+				}
+				advance(layout::stop + avr_driver::stop_cycles);
+				drive(base::mark);
+			}
+		};
+
+		/** avr::rs485_driver, DE is recorded in pin_trace(de_port, de_pin),
+		 *  lead cycles before the start edge and at the end of cbi			*/
+		template<uint8_t port, uint8_t ddr, uint8_t pin, uint8_t de_port,
+				 uint8_t de_ddr, uint8_t de_pin, clock_t clock,
+				 time_t enable_ns = 0, uint8_t space = uart_space_level>
+		struct rs485_driver : model<avr::rs485_driver<port, ddr, pin,
+				de_port, de_ddr, de_pin, clock, enable_ns, space>, 10, space> {
+			using base = model<avr::rs485_driver<port, ddr, pin,
+				de_port, de_ddr, de_pin, clock, enable_ns, space>, 10, space>;
+			static constexpr cycle_t lead = avr::rs485_driver<port, ddr, pin,
+				de_port, de_ddr, de_pin, clock, enable_ns, space>::lead;
+			static inline trace_t& enable() {
+				return pin_trace(de_port, de_pin);
+			}
+			static inline void init() {
+				base::init();
+				enable().clear();
+			}
+			static inline void start(uint8_t data) {
+				begin(data);
+				base::resume();
+			}
+			/** DE rises lead cycles before the out of resume			*/
+			static inline void begin(uint8_t data) {
+				advance(lead);
+				base::begin(data);
+				enable().push_back(edge{now() + 1 - lead, 1});
+			}
+			static inline void begin_P(const uint8_t*& data) {
+				advance(lead);
+				base::begin_P(data);
+				enable().push_back(edge{now() + 1 - lead, 1});
+			}
+			static inline void stop(uint8_t) {
+				base::hold();
+			}
+			static inline void release() {}
+			/** cbi, out SREG												*/
+			static inline void done() {
+				base::done();
+				enable().push_back(edge{now(), 0});
+				advance(1);
+			}
+			template<bool supported = false>
+			static inline void put(uint8_t) {
+				static_assert(supported, "Async mode is not supported by rs485_driver");
+			}
+		};
+
+		/** avr::cts_driver, CTS is deasserted in the window given to
+		 *  deassert(), each sbic/rjmp poll takes cts_poll_cycles			*/
+		template<uint8_t port, uint8_t ddr, uint8_t pin, uint8_t cts_pinx,
+				 uint8_t cts_pin, bool burst_wait = false,
+				 uint8_t space = uart_space_level>
+		struct cts_driver : model<avr::cts_driver<port, ddr, pin,
+				cts_pinx, cts_pin, burst_wait, space>, 10, space> {
+			using base = model<avr::cts_driver<port, ddr, pin,
+				cts_pinx, cts_pin, burst_wait, space>, 10, space>;
+			static constexpr cycle_t cts_poll_cycles = avr::cts_driver<port,
+				ddr, pin, cts_pinx, cts_pin, burst_wait, space>::cts_poll_cycles;
+			/** deassert CTS from the given cycle until the other one		*/
+			static inline void deassert(cycle_t from, cycle_t until) {
+				window().from = from;
+				window().until = until;
+			}
+			static inline bool asserted(cycle_t at) {
+				return at < window().from || at >= window().until;
+			}
+			/** before cli, not timed										*/
+			static inline void start(uint8_t data) {
+				begin(data);
+				base::resume();
+			}
+			static inline void begin(uint8_t data) {
+				while( ! asserted(now()) ) advance(1);
+				base::begin(data);
+			}
+			static inline void begin_P(const uint8_t*& data) {
+				while( ! asserted(now()) ) advance(1);
+				base::begin_P(data);
+			}
+			/** branch, mov, then polls with burst_wait					*/
+			template<bool late = false>
+			static inline void restart() {
+				if( burst_wait ) poll(now() + branch_cycles + (late ? 0 : 1));
+				base::template restart<late>();
+			}
+			static inline void restart_P() {
+				if( burst_wait ) poll(now());
+				base::restart_P();
+			}
+			template<bool supported = false>
+			static inline void put(uint8_t) {
+				static_assert(supported, "Async mode is not supported by cts_driver");
+			}
+		private:
+			struct deasserted {
+				cycle_t from;
+				cycle_t until;
+			};
+			static inline deasserted& window() {
+				static deasserted w = { 0, 0 };
+				return w;
+			}
+			/* sbic at the given cycle and every cts_poll_cycles after		*/
+			static inline void poll(cycle_t at) {
+				for(; ! asserted(at); at += cts_poll_cycles)
+					advance(cts_poll_cycles);
+			}
+		};
+
+		/** avr::packet_steps, same cost and effect on the cursor			*/
+		template<packet_cursor& c>
+		struct packet_steps {
+			static constexpr cycle_t crc_cycles = avr::packet_steps<c>::crc_cycles;
+			static constexpr cycle_t scan_cycles = avr::packet_steps<c>::scan_cycles;
+			static inline void crc() {
+				if( c.crc_at != c.end )
+					c.crc = crc16_ccitt(c.crc, *c.crc_at++);
+				advance(crc_cycles);
+			}
+			static inline void scan() {
+				if( c.open && c.scan_at != c.end ) {
+					if( *c.scan_at == 0 )
+						c.open = 0;
+					else {
+						++c.scan_at;
+						if( ++c.run == 254 ) c.open = 0;
+					}
+				}
+				advance(scan_cycles);
+			}
+		};
+
+		/** avr::parallel_driver, each pin keeps its own pin_trace		*/
+		template<uint8_t port, uint8_t ddr, uint8_t mask, uint8_t space = uart_space_level>
+		struct parallel_driver {
+			using mcu = sim;
+			using avr_driver = avr::parallel_driver<port, ddr, mask, space>;
+			static constexpr cycle_t send_cycles  = avr_driver::send_cycles;
+			static constexpr cycle_t start_cycles = avr_driver::start_cycles;
+			static constexpr cycle_t stop_cycles  = avr_driver::stop_cycles;
+			static constexpr uint8_t channels = avr_driver::channels;
+
+			static inline void init() {
+				reset();
+				for(uint8_t pin = 0; pin < 8; ++pin)
+					if( (mask >> pin) & 1 ) pin_trace(port, pin).clear();
+				io(port) = space ? io(port) & ~mask : io(port) | mask;
+			}
+			/** the same images as avr::parallel_driver::prepare, not timed	*/
+			static inline void prepare(uint8_t* image, const uint8_t* data) {
+				const uint8_t base = io(port) & ~mask;
+				const uint8_t mark = space ? 0 : mask;
+				for(uint8_t bit = 0; bit < 8; ++bit) {
+					uint8_t plane = 0;
+					const uint8_t* channel = data;
+					for(uint8_t pin = 0; pin < 8; ++pin) {
+						if( (mask & (1<<pin)) == 0 ) continue;
+						if( (*channel++ >> bit) & 1 ) plane |= (1<<pin);
+					}
+					image[bit+1] = base | (space ? (mask & ~plane) : plane);
+				}
+				image[0] = base | (mark ^ mask);
+				image[9] = base | mark;
+			}
+			/** in, cli, ld, out											*/
+			static inline void start(const uint8_t*& slot) {
+				advance(5);
+				write(port, *slot++);
+			}
+			static inline void send(const uint8_t*& slot) {
+				advance(send_cycles);
+				write(port, *slot++);
+			}
+			/** ld, out, out SREG											*/
+			static inline void stop(const uint8_t*& slot) {
+				advance(stop_cycles);
+				write(port, *slot++);
+				advance(1);
+			}
+		};
+
+		/** avr::input, samples a scripted line: stimulus() holds its edges
+		 *  in cycles, the line is MARK before the first one
+		  * params
+		  *   space		- SPACE level								*/
+		template<uint8_t space = uart_space_level>
+		struct input {
+			using mcu = sim;
+			using avr_input = avr::input<0, 0, 0, 0, space>;
+			static constexpr cycle_t sample_cycles  = avr_input::sample_cycles;
+			static constexpr cycle_t sample_lead    = avr_input::sample_lead;
+			static constexpr cycle_t start_cycles   = avr_input::start_cycles;
+			static constexpr cycle_t confirm_cycles = avr_input::confirm_cycles;
+			static constexpr cycle_t confirm_lead   = avr_input::confirm_lead;
+			static constexpr cycle_t stop_cycles    = avr_input::stop_cycles;
+			static constexpr cycle_t stop_lead      = avr_input::stop_lead;
+			static constexpr milicycle_t detect_latency = avr_input::detect_latency;
+			static constexpr uint8_t mark = space ? 0 : 1;
+
+			/** edges of the line to receive								*/
+			static inline trace_t& stimulus() {
+				static trace_t edges;
+				return edges;
+			}
+			/** line level at the given cycle								*/
+			static inline uint8_t level(cycle_t at) {
+				uint8_t value = mark;
+				for(const edge& e : stimulus()) {
+					if( e.at > at ) break;
+					value = e.level;
+				}
+				return value;
+			}
+			static inline void init() {
+				now() = 0;
+				stimulus().clear();
+			}
+			/** ldi, in, cli, then a sbic/rjmp poll every 3 cycles, gives
+			 *  up on a line that stays MARK, so a failing check ends		*/
+			static inline uint8_t start(uint8_t& data) {
+				data = 0;
+				advance(3);
+				while( level(now()) == mark ) {
+					if( stimulus().empty() || stimulus().back().at <= now() )
+						break;
+					advance(3);
+				}
+				advance(start_cycles);
+				return 0;
+			}
+			static inline bool confirm() {
+				advance(confirm_lead);
+				const bool held = level(now()) != mark;
+				advance(confirm_cycles - confirm_lead);
+				return held;
+			}
+			/** breq taken, out SREG										*/
+			static inline bool reject(uint8_t) {
+				advance(2);
+				return false;
+			}
+			template<uint8_t bit>
+			static inline void sample(uint8_t& data) {
+				advance(sample_lead);
+				if( level(now()) == mark )
+					data |= 1 << bit;
+				advance(sample_cycles - sample_lead);
+			}
+			static inline bool stop(uint8_t) {
+				advance(stop_lead);
+				const bool ok = level(now()) == mark;
+				advance(stop_cycles - stop_lead);
+				return ok;
+			}
+		};
+
+		/** timer compare unit for hast::async, keeps the compare time in
+		 *  cycles. run() calls the handler at each compare match			*/
+		template<uint16_t prescale, typename count = uint8_t>
+		struct timer {
+			using count_t = count;
+			static constexpr uint16_t prescaler = prescale;
+			static constexpr count_t max_count = static_cast<count_t>(~0U);
+			static inline void init() {
+				state().enabled = false;
+			}
+			/* in, subi, out, ldi, out of avr::timer0						*/
+			static constexpr cycle_t schedule_cycles = 5;
+			/** a compare that matches before the flag is cleared is lost,
+			 *  the next one comes a full timer period later				*/
+			static inline void schedule(count_t ticks) {
+				const cycle_t at = (now() / prescale + ticks) * prescale;
+				now() += schedule_cycles;
+				state().next = at > now() ? at
+					: at + (static_cast<cycle_t>(max_count) + 1) * prescale;
+				state().enabled = true;
+			}
+			static inline void advance(count_t ticks) {
+				state().next += ticks * prescale;
+			}
+			static inline void disable() {
+				state().enabled = false;
+			}
+			/* interrupt windows, timing of avr::timer0					*/
+			static constexpr cycle_t read_cycles = 1;
+			static constexpr cycle_t poll_cycles = 4;
+			static constexpr cycle_t window_cycles = 8;
+			/** cycles taken by interrupts in each window					*/
+			static inline cycle_t& load() {
+				static cycle_t cycles = 0;
+				return cycles;
+			}
+			/** count of the longest interval without a window, cycles	*/
+			static inline cycle_t& blocked() {
+				static cycle_t cycles = 0;
+				return cycles;
+			}
+			/** in r25, TCNT												*/
+			static inline uint8_t capture() {
+				const uint8_t tcnt = static_cast<uint8_t>(now() / prescale);
+				state().opened = now();
+				now() += read_cycles;
+				return tcnt;
+			}
+			/** out, nop, cli, interrupts, mov, subi, poll loop				*/
+			template<uint8_t target>
+			static inline void window(uint8_t origin) {
+				if( now() - state().opened > blocked() )
+					blocked() = now() - state().opened;
+				now() += 3 + load() + 2;
+				for(;;) {
+					const uint8_t diff = static_cast<uint8_t>(
+						now() / prescale - origin - target);
+					now() += read_cycles + 2;
+					if( diff < 0x80 ) break;
+					now() += 1;
+				}
+				state().opened = now();
+			}
+			/** run handler at compare matches while enabled				*/
+			template<typename handler>
+			static void run() {
+				while( state().enabled ) {
+					now() = state().next + isr_entry_cycles;
+					handler::isr();
+				}
+			}
+		private:
+			struct compare {
+				cycle_t next;
+				bool enabled;
+				cycle_t opened;	/* last window, cycles					*/
+			};
+			static inline compare& state() {
+				static compare c = { 0, false, 0 };
+				return c;
+			}
+		};
+
+		/** Ideal UART decoder, checks a trace against expected data		*/
+		template<clock_t clock, clock_t baudrate, uint8_t space = uart_space_level,
+			typename format = frame<>>
+		struct uart {
+			using data_t = typename format::data_t;
+			static constexpr uint8_t mark = space ? 0 : 1;
+			struct report {
+				size_t frames;		/* frames decoded					*/
+				size_t errors;		/* data, parity and framing errors	*/
+				time_t max_error;	/* worst edge error, ns				*/
+			};
+			/** time of a cycle in ns										*/
+			static constexpr time_t ns(cycle_t cycles) {
+				return (nano * cpi * cycles) / clock;
+			}
+			static constexpr time_t bit_ns = nano / baudrate;
+
+			/** level of the trace at the given time, ns					*/
+			static uint8_t level(const trace_t& edges, time_t at) {
+				uint8_t value = mark;
+				for(const edge& e : edges) {
+					if( ns(e.at) > at ) break;
+					value = e.level;
+				}
+				return value;
+			}
+
+			/** frame bits sampled at mid-bit, start edge at start		*/
+			static uint16_t sample(const trace_t& edges, time_t start) {
+				uint16_t bits = 0;
+				for(uint8_t bit = 0; bit < format::bits; ++bit) {
+					const time_t mid = start + bit_ns * (bit + 1) + bit_ns / 2;
+					if( level(edges, mid) == mark ) bits |= 1U << bit;
+				}
+				return bits;
+			}
+			/** data from frame bits										*/
+			static data_t unwire(uint16_t bits) {
+				return format::bit_order == bitorder::msb
+					? format::reverse(bits, format::data_bits)
+					: bits & ((1U << format::data_bits) - 1);
+			}
+
+			/** decode all frames of the trace, no checks				*/
+			static std::vector<data_t> read(const trace_t& edges) {
+				std::vector<data_t> res;
+				time_t end = -1;
+				for(const edge& e : edges) {
+					const time_t at = ns(e.at);
+					if( e.level == mark || at <= end ) continue;
+					res.push_back(unwire(sample(edges, at)));
+					end = at + bit_ns * (format::bits + 1);
+				}
+				return res;
+			}
+
+			/** decode trace, compare frames with expected data			*/
+			static report decode(const trace_t& edges,
+								 const data_t* expected, size_t n) {
+				report res = { 0, 0, 0 };
+				size_t i = 0;
+				while( i < edges.size() && res.frames < n ) {
+					if( edges[i].level == mark ) { ++i; continue; }
+					const time_t start = ns(edges[i].at);
+					const uint16_t bits = sample(edges, start);
+					const time_t stop = start + bit_ns * (format::bits + 1) + bit_ns / 2;
+					const data_t data = unwire(bits);
+					if( level(edges, stop) != mark ||
+						format::wire(data, true) != bits ||
+						data != expected[res.frames] )
+						++res.errors;
+					/* edge errors against ideal bit boundaries			*/
+					++i;
+					while( i < edges.size() && ns(edges[i].at) < stop ) {
+						const time_t offs = ns(edges[i].at) - start;
+						const time_t ideal = ((offs + bit_ns/2) / bit_ns) * bit_ns;
+						if( abs(offs - ideal) > res.max_error )
+							res.max_error = abs(offs - ideal);
+						++i;
+					}
+					++res.frames;
+				}
+				res.errors += n - res.frames;
+				return res;
+			}
+		};
+
+		/** write trace as a VCD waveform, timescale 1 ns				*/
+		template<clock_t clock>
+		static void vcd(FILE* out, const trace_t& edges, uint8_t idle = 1) {
+			fprintf(out, "$timescale 1ns $end\n"
+						 "$scope module hast $end\n"
+						 "$var wire 1 ! tx $end\n"
+						 "$upscope $end\n"
+						 "$enddefinitions $end\n"
+						 "#0\n%u!\n", idle);
+			for(const edge& e : edges)
+				fprintf(out, "#%lld\n%u!\n",
+						static_cast<long long>((nano * cpi * e.at) / clock), e.level);
+		}
+	};
+}